@@ -0,0 +1,78 @@
+/*
+ * The "arena" module contains the Arena struct and relevant use functions.
+ * An Arena is a single block of memory that is sized up front, and that buffers are taken
+ * from one after the other (by bumping an offset). The buffers are never freed one by one:
+ * they are all released together, by resetting or destroying the arena.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+#include "board_utils.h"
+
+/* every buffer starts at a multiple of this, which is enough for the types the game keeps in arenas */
+#define ARENA_ALIGN sizeof(double)
+
+
+/*
+ * Returns the amount of bytes a buffer of the given size takes in an arena
+ * (buffers are aligned, so every one of them may hold any type).
+ */
+size_t arena_size_of(size_t size){
+	return (size + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+}
+
+/*
+ * Creates an arena of the given size in bytes.
+ * Its size should be the sum of arena_size_of of every buffer that will be taken from it.
+ */
+Arena* create_arena(size_t size){
+	Arena* arena = (Arena*) malloc(sizeof(Arena));
+	if(arena == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	arena->base = (char*) malloc(size > 0 ? size : 1);
+	if(arena->base == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	arena->size = size;
+	arena->used = 0;
+	return arena;
+}
+
+/*
+ * Destroys properly a given Arena, freeing all buffers taken from it at once.
+ */
+void destroy_arena(Arena* arena){
+	if(arena == NULL)
+		return;
+	free(arena->base);
+	free(arena);
+}
+
+/*
+ * Returns a buffer of the given size in bytes from the arena.
+ * The arena must have been created large enough for it.
+ */
+void* arena_alloc(Arena* arena, size_t size){
+	void* buffer;
+
+	size = arena_size_of(size);
+	if(arena->used + size > arena->size){
+		printf("Error: an arena of %lu bytes ran out of room.\n", (unsigned long) arena->size);
+		exit(0);
+	}
+	buffer = arena->base + arena->used;
+	arena->used += size;
+	return buffer;
+}
+
+/*
+ * Releases all buffers taken from the arena, so it can be used again from it's start.
+ */
+void arena_reset(Arena* arena){
+	arena->used = 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * The "arena" module contains the Arena struct and relevant use functions.
+ * An Arena is a single block of memory that is sized up front, and that buffers are taken
+ * from one after the other (by bumping an offset). The buffers are never freed one by one:
+ * they are all released together, by resetting or destroying the arena.
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stddef.h>
+
+
+/*
+ * Structure: Arena
+ * 		A block of memory that buffers are taken from in order.
+ *
+ * 		base: the block of memory.
+ * 		size: the amount of bytes in the block.
+ * 		used: the amount of bytes already taken from the block.
+ */
+typedef struct arena_t{
+	char* base;
+	size_t size;
+	size_t used;
+} Arena;
+
+
+/*
+ * Returns the amount of bytes a buffer of the given size takes in an arena
+ * (buffers are aligned, so every one of them may hold any type).
+ */
+size_t arena_size_of(size_t size);
+
+/*
+ * Creates an arena of the given size in bytes.
+ * Its size should be the sum of arena_size_of of every buffer that will be taken from it.
+ */
+Arena* create_arena(size_t size);
+
+/*
+ * Destroys properly a given Arena, freeing all buffers taken from it at once.
+ */
+void destroy_arena(Arena* arena);
+
+/*
+ * Returns a buffer of the given size in bytes from the arena.
+ * The arena must have been created large enough for it.
+ */
+void* arena_alloc(Arena* arena, size_t size);
+
+/*
+ * Releases all buffers taken from the arena, so it can be used again from it's start.
+ */
+void arena_reset(Arena* arena);
+
+#endif /* ARENA_H_ */
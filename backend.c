@@ -0,0 +1,128 @@
+/*
+ * The "backend" module puts the solvers of the game behind a single interface, so VALIDATE,
+ * HINT and GENERATE work with whichever solver the user chose with the backend command:
+ * the backtracking search, ilp, dancing links or sat.
+ * NUM_SOLUTIONS, NUM_SOLUTIONS_UPTO and the check of SAVE in edit mode count with the chosen
+ * solver too when it can: ilp can't count, and sat only counts upto a limit, so the counts they
+ * can't make are made by the backtracking search.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "game.h"
+#include "solver.h"
+#include "gurobi_utils.h"
+#include "dlx.h"
+#include "sat.h"
+#include "parallel.h"
+#include "backend.h"
+
+
+/*
+ * The following 4 functions check if a board has a solution with a single solver.
+ * Each returns 1 if the board has a solution, -1 if it has none and 0 on an error.
+ */
+int search_is_feasible(Board* board){
+	return search_count_upto(board, 1) == 1 ? 1 : -1;
+}
+
+int ilp_is_feasible(Board* board){
+	return find_ILP_solution(board, 0);
+}
+
+int dlx_is_feasible(Board* board){
+	return dlx_num_solutions(board, 1) == 1 ? 1 : -1;
+}
+
+/*
+ * Counts the solutions of a board with Dancing Links, upto limit (which keeps the count in an int).
+ */
+int dlx_count_upto(Board* board, int limit){
+	return (int) dlx_num_solutions(board, limit);
+}
+
+/*
+ * Counts all the solutions of a board with Dancing Links. It can't be stopped, so it always finishes.
+ */
+int dlx_count_all(Board* board, BigNum* result){
+	bignum_set(result, dlx_num_solutions(board, 0));
+	return 1;
+}
+
+int sat_is_feasible(Board* board){
+	return sat_find_solution(board, 0);
+}
+
+/*
+ * Counts all the solutions of a board with the backtracking search, with the threads,
+ * propagation and symmetry settings of the game (see exact_num_solutions).
+ */
+int search_count_all(Board* board, BigNum* result){
+	return exact_num_solutions(board, num_threads, result);
+}
+
+
+Backend search_backend = {"backtracking", find_exact_solution, search_is_feasible, search_count_upto,
+		search_count_all};
+Backend ilp_backend = {"ilp", find_ILP_solution, ilp_is_feasible, NULL, NULL};
+Backend dlx_backend = {"dancing links", dlx_find_solution, dlx_is_feasible, dlx_count_upto, dlx_count_all};
+/*the sat solver counts by excluding every solution it finds, which is only fit for small limits*/
+Backend sat_backend = {"sat", sat_find_solution, sat_is_feasible, sat_count_upto, NULL};
+
+/* the solvers, by their backend_id */
+Backend* backends[NUM_BACKENDS] = {&search_backend, &ilp_backend, &dlx_backend, &sat_backend};
+
+
+/*
+ * Returns the solver chosen by solver_backend.
+ */
+Backend* current_backend(){
+	return backends[solver_backend];
+}
+
+/*
+ * Finds a solution to the given board with the chosen solver.
+ * If a solution is found, returns 1. If there is no solution, returns -1. On an error returns 0.
+ * When given save_solution as 1, the found solution (if exists) is saved on the given board.
+ * For use of the VALIDATE, HINT and GENERATE commands.
+ */
+int find_solution(Board* board, int save_solution){
+	return current_backend()->find_solution(board, save_solution);
+}
+
+/*
+ * Checks with the chosen solver if the given board has a solution.
+ * Returns 1 if it has one, -1 if it has none and 0 on an error.
+ */
+int is_feasible(Board* board){
+	return current_backend()->is_feasible(board);
+}
+
+/*
+ * Function recieves a board, and returns the number of possible solutions for the board's
+ * current state, but stops counting once limit solutions were found (and then returns limit).
+ * limit <= 0 means no limit. Counts with the chosen solver, or with the backtracking search
+ * if it can't count. Meant for small limits - NUM_SOLUTIONS counts all the solutions with
+ * count_all_solutions instead, since their number can outgrow an int.
+ * For example, limit == 2 tells if the board has no solution, a unique one or more.
+ */
+int count_solutions_upto(Board* board, int limit){
+	if(check_board_errors(board) == 1)
+		return 0;
+	if(current_backend()->count_upto == NULL)
+		return search_count_upto(board, limit);
+	return current_backend()->count_upto(board, limit);
+}
+
+/*
+ * Puts the exact number of solutions of the board's current state in result, counted with the
+ * chosen solver, or with the backtracking search if it can't count all the solutions.
+ * Returns 1 if the count finished, or 0 if the user stopped it (result then has the partial count).
+ * For use of the NUM_SOLUTIONS command.
+ */
+int count_all_solutions(Board* board, BigNum* result){
+	if(current_backend()->count_all == NULL)
+		return search_backend.count_all(board, result);
+	return current_backend()->count_all(board, result);
+}
@@ -0,0 +1,83 @@
+/*
+ * The "backend" module puts the solvers of the game behind a single interface, so VALIDATE,
+ * HINT and GENERATE work with whichever solver the user chose with the backend command:
+ * the backtracking search, ilp, dancing links or sat.
+ * NUM_SOLUTIONS, NUM_SOLUTIONS_UPTO and the check of SAVE in edit mode count with the chosen
+ * solver too when it can: ilp can't count, and sat only counts upto a limit, so the counts they
+ * can't make are made by the backtracking search.
+ */
+
+#ifndef BACKEND_H_
+#define BACKEND_H_
+
+#include "board_utils.h"
+#include "bignum.h"
+
+
+/*
+ * Structure: Backend
+ * 		The operations of a single solver.
+ *
+ * 		name: the name of the solver.
+ * 		find_solution: tries to find a solution to the board. Returns 1 if one was found, -1 if there
+ * 		               is none and 0 on an error. When given save_solution as 1, the found solution
+ * 		               is saved on the board.
+ * 		is_feasible: returns 1 if the board has a solution, -1 if it has none and 0 on an error.
+ * 		count_upto: returns the number of solutions of the board, stopping once limit were found
+ * 		            (limit <= 0 means no limit). Used by NUM_SOLUTIONS_UPTO, and by SAVE in edit
+ * 		            mode to check the board has a solution. NULL if the solver can't count solutions.
+ * 		count_all: puts the exact number of solutions of the board in result. Returns 1 if the
+ * 		           count finished, or 0 if the user stopped it (result then has the partial count).
+ * 		           NULL if the solver can't count all the solutions.
+ */
+typedef struct backend_t{
+	const char* name;
+	int (*find_solution)(Board* board, int save_solution);
+	int (*is_feasible)(Board* board);
+	int (*count_upto)(Board* board, int limit);
+	int (*count_all)(Board* board, BigNum* result);
+} Backend;
+
+
+/* the solvers, by their backend_id */
+extern Backend* backends[NUM_BACKENDS];
+
+
+/*
+ * Returns the solver chosen by solver_backend.
+ */
+Backend* current_backend();
+
+/*
+ * Finds a solution to the given board with the chosen solver.
+ * If a solution is found, returns 1. If there is no solution, returns -1. On an error returns 0.
+ * When given save_solution as 1, the found solution (if exists) is saved on the given board.
+ * For use of the VALIDATE, HINT and GENERATE commands.
+ */
+int find_solution(Board* board, int save_solution);
+
+/*
+ * Checks with the chosen solver if the given board has a solution.
+ * Returns 1 if it has one, -1 if it has none and 0 on an error.
+ */
+int is_feasible(Board* board);
+
+/*
+ * Function recieves a board, and returns the number of possible solutions for the board's
+ * current state, but stops counting once limit solutions were found (and then returns limit).
+ * limit <= 0 means no limit. Counts with the chosen solver, or with the backtracking search
+ * if it can't count. Meant for small limits - NUM_SOLUTIONS counts all the solutions with
+ * count_all_solutions instead, since their number can outgrow an int.
+ * For example, limit == 2 tells if the board has no solution, a unique one or more.
+ */
+int count_solutions_upto(Board* board, int limit);
+
+/*
+ * Puts the exact number of solutions of the board's current state in result, counted with the
+ * chosen solver, or with the backtracking search if it can't count all the solutions.
+ * Returns 1 if the count finished, or 0 if the user stopped it (result then has the partial count).
+ * For use of the NUM_SOLUTIONS command.
+ */
+int count_all_solutions(Board* board, BigNum* result);
+
+#endif /* BACKEND_H_ */
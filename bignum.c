@@ -0,0 +1,76 @@
+/*
+ * The "bignum" module contains the BigNum struct and relevant use functions,
+ * that are used for keeping solution counts too large for the C integer types
+ * (the solutions of a near empty board are far beyond 2^64).
+ * Only what counting needs is supported: setting, adding, multiplying by a small factor and printing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bignum.h"
+
+
+/*
+ * Sets num to the given value.
+ */
+void bignum_set(BigNum* num, unsigned long value){
+	num->num_limbs = 1;
+	num->limbs[0] = 0;
+	bignum_add(num, value);
+}
+
+/*
+ * Adds the given value to num.
+ */
+void bignum_add(BigNum* num, unsigned long value){
+	int i;
+	unsigned long sum;
+
+	for(i = 0; value != 0; i++){
+		if(i == num->num_limbs){
+			if(num->num_limbs == BIGNUM_MAX_LIMBS){
+				printf("Error: solution count is too large to keep.\n");
+				exit(0);
+			}
+			num->limbs[num->num_limbs++] = 0;
+		}
+		sum = (unsigned long) num->limbs[i] + value % BIGNUM_BASE;
+		num->limbs[i] = (int) (sum % BIGNUM_BASE);
+		value = value / BIGNUM_BASE + sum / BIGNUM_BASE;
+	}
+}
+
+/*
+ * Multiplies num by factor (0 to BIGNUM_BASE).
+ */
+void bignum_mul(BigNum* num, int factor){
+	int i;
+	long product, carry = 0;
+
+	for(i = 0; i < num->num_limbs; i++){
+		product = (long) num->limbs[i] * factor + carry;
+		num->limbs[i] = (int) (product % BIGNUM_BASE);
+		carry = product / BIGNUM_BASE;
+	}
+	while(carry != 0){
+		if(num->num_limbs == BIGNUM_MAX_LIMBS){
+			printf("Error: solution count is too large to keep.\n");
+			exit(0);
+		}
+		num->limbs[num->num_limbs++] = (int) (carry % BIGNUM_BASE);
+		carry /= BIGNUM_BASE;
+	}
+	while(num->num_limbs > 1 && num->limbs[num->num_limbs - 1] == 0)
+		num->num_limbs--;
+}
+
+/*
+ * Prints num in decimal, with no new line.
+ */
+void bignum_print(BigNum* num){
+	int i;
+	printf("%d", num->limbs[num->num_limbs - 1]);
+	for(i = num->num_limbs - 2; i >= 0; i--)
+		printf("%0*d", BIGNUM_BASE_DIGITS, num->limbs[i]);
+}
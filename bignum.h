@@ -0,0 +1,51 @@
+/*
+ * The "bignum" module contains the BigNum struct and relevant use functions,
+ * that are used for keeping solution counts too large for the C integer types
+ * (the solutions of a near empty board are far beyond 2^64).
+ * Only what counting needs is supported: setting, adding, multiplying by a small factor and printing.
+ */
+
+#ifndef BIGNUM_H_
+#define BIGNUM_H_
+
+/* every limb keeps BIGNUM_BASE_DIGITS decimal digits */
+#define BIGNUM_BASE 10000
+#define BIGNUM_BASE_DIGITS 4
+/* enough for (2^64) * 99! with room to spare */
+#define BIGNUM_MAX_LIMBS 64
+
+
+/*
+ * Structure: BigNum
+ * 		Used to represent a non negative integer of up to BIGNUM_MAX_LIMBS * BIGNUM_BASE_DIGITS digits.
+ *
+ * 		num_limbs: the amount of limbs in use (at least 1).
+ * 		limbs: the number in base BIGNUM_BASE, least significant limb first.
+ */
+typedef struct bignum_t{
+	int num_limbs;
+	int limbs[BIGNUM_MAX_LIMBS];
+} BigNum;
+
+
+/*
+ * Sets num to the given value.
+ */
+void bignum_set(BigNum* num, unsigned long value);
+
+/*
+ * Adds the given value to num.
+ */
+void bignum_add(BigNum* num, unsigned long value);
+
+/*
+ * Multiplies num by factor (0 to BIGNUM_BASE).
+ */
+void bignum_mul(BigNum* num, int factor);
+
+/*
+ * Prints num in decimal, with no new line.
+ */
+void bignum_print(BigNum* num);
+
+#endif /* BIGNUM_H_ */
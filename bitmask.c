@@ -0,0 +1,126 @@
+/*
+ * The "bitmask" module contains the ValueMask struct and relevant use functions,
+ * that are used for keeping sets of cell values (1 to board_size) as bits.
+ * Each value v is kept at bit (v - 1), so a board of up to MAX_MASK_VALUES values
+ * is represented by a fixed amount of words.
+ */
+
+#include "bitmask.h"
+
+
+/*
+ * Empties the given mask.
+ */
+void mask_clear(ValueMask* mask){
+	int i;
+	for(i = 0; i < MASK_WORDS; i++)
+		mask->words[i] = 0;
+}
+
+/*
+ * Sets the given mask to hold all values 1 to max_value.
+ */
+void mask_fill(ValueMask* mask, int max_value){
+	int i;
+	int bits_left = max_value;
+	for(i = 0; i < MASK_WORDS; i++){
+		if(bits_left >= MASK_WORD_BITS)
+			mask->words[i] = ~0UL;
+		else if(bits_left > 0)
+			mask->words[i] = (1UL << bits_left) - 1;
+		else
+			mask->words[i] = 0;
+		bits_left -= MASK_WORD_BITS;
+	}
+}
+
+/*
+ * Adds a single value to the mask.
+ */
+void mask_add(ValueMask* mask, int value){
+	mask->words[(value - 1) / MASK_WORD_BITS] |= 1UL << ((value - 1) % MASK_WORD_BITS);
+}
+
+/*
+ * Removes a single value from the mask.
+ */
+void mask_remove(ValueMask* mask, int value){
+	mask->words[(value - 1) / MASK_WORD_BITS] &= ~(1UL << ((value - 1) % MASK_WORD_BITS));
+}
+
+/*
+ * Returns 1 if the value is in the mask, 0 otherwise.
+ */
+int mask_has(ValueMask* mask, int value){
+	return (int) ((mask->words[(value - 1) / MASK_WORD_BITS] >> ((value - 1) % MASK_WORD_BITS)) & 1UL);
+}
+
+/*
+ * Puts in result the union of a, b and c (result may be one of them).
+ */
+void mask_union3(ValueMask* result, ValueMask* a, ValueMask* b, ValueMask* c){
+	int i;
+	for(i = 0; i < MASK_WORDS; i++)
+		result->words[i] = a->words[i] | b->words[i] | c->words[i];
+}
+
+/*
+ * Puts in result all values of full that are not in used (result may be one of them).
+ */
+void mask_and_not(ValueMask* result, ValueMask* full, ValueMask* used){
+	int i;
+	for(i = 0; i < MASK_WORDS; i++)
+		result->words[i] = full->words[i] & ~(used->words[i]);
+}
+
+/*
+ * Returns the amount of set bits in a single word.
+ */
+int word_count(unsigned long word){
+	int count = 0;
+	while(word != 0){
+		word &= word - 1;
+		count++;
+	}
+	return count;
+}
+
+/*
+ * Returns the amount of values in the mask.
+ */
+int mask_count(ValueMask* mask){
+	int i;
+	int count = 0;
+	for(i = 0; i < MASK_WORDS; i++)
+		count += word_count(mask->words[i]);
+	return count;
+}
+
+/*
+ * Returns the smallest value in the mask that is bigger than after.
+ * If there is none, returns 0.
+ * (mask_next(mask, 0) returns the smallest value in the mask)
+ */
+int mask_next(ValueMask* mask, int after){
+	int i = after / MASK_WORD_BITS;
+	int bit = after % MASK_WORD_BITS;
+	unsigned long word;
+
+	if(i >= MASK_WORDS)
+		return 0;
+	word = mask->words[i] >> bit;
+	while(1){
+		if(word != 0){
+			while((word & 1UL) == 0){
+				word >>= 1;
+				bit++;
+			}
+			return i * MASK_WORD_BITS + bit + 1;
+		}
+		i++;
+		if(i >= MASK_WORDS)
+			return 0;
+		word = mask->words[i];
+		bit = 0;
+	}
+}
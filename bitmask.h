@@ -0,0 +1,80 @@
+/*
+ * The "bitmask" module contains the ValueMask struct and relevant use functions,
+ * that are used for keeping sets of cell values (1 to board_size) as bits.
+ * Each value v is kept at bit (v - 1), so a board of up to MAX_MASK_VALUES values
+ * is represented by a fixed amount of words.
+ */
+
+#ifndef BITMASK_H_
+#define BITMASK_H_
+
+#include <limits.h>
+
+/* the biggest board load_board accepts has m*n = 99 values */
+#define MAX_MASK_VALUES 99
+
+#if ULONG_MAX > 0xFFFFFFFFUL
+#define MASK_WORD_BITS 64
+#else
+#define MASK_WORD_BITS 32
+#endif
+
+#define MASK_WORDS ((MAX_MASK_VALUES + MASK_WORD_BITS - 1) / MASK_WORD_BITS)
+
+
+/*
+ * Structure: ValueMask
+ * 		Used to represent a set of values in the range 1-MAX_MASK_VALUES.
+ *
+ * 		words: the bits of the set. value v is saved at bit (v-1) % MASK_WORD_BITS
+ * 		       of words[(v-1) / MASK_WORD_BITS].
+ */
+typedef struct value_mask_t{
+	unsigned long words[MASK_WORDS];
+} ValueMask;
+
+
+/*
+ * Empties the given mask.
+ */
+void mask_clear(ValueMask* mask);
+
+/*
+ * Sets the given mask to hold all values 1 to max_value.
+ */
+void mask_fill(ValueMask* mask, int max_value);
+
+/*
+ * Adds / removes a single value to / from the mask.
+ */
+void mask_add(ValueMask* mask, int value);
+void mask_remove(ValueMask* mask, int value);
+
+/*
+ * Returns 1 if the value is in the mask, 0 otherwise.
+ */
+int mask_has(ValueMask* mask, int value);
+
+/*
+ * Puts in result the union of a, b and c (result may be one of them).
+ */
+void mask_union3(ValueMask* result, ValueMask* a, ValueMask* b, ValueMask* c);
+
+/*
+ * Puts in result all values of full that are not in used (result may be one of them).
+ */
+void mask_and_not(ValueMask* result, ValueMask* full, ValueMask* used);
+
+/*
+ * Returns the amount of values in the mask.
+ */
+int mask_count(ValueMask* mask);
+
+/*
+ * Returns the smallest value in the mask that is bigger than after.
+ * If there is none, returns 0.
+ * (mask_next(mask, 0) returns the smallest value in the mask)
+ */
+int mask_next(ValueMask* mask, int after);
+
+#endif /* BITMASK_H_ */
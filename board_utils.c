@@ -13,19 +13,14 @@
 #include "parser.h"
 #include "solver.h"
 #include "linked_list.h"
+#include "mask_kernels.h"
 
 
 /*
- * Gets a pointer to a cell, and initializes it with given value.
- * fixed == 1 means cell is fixed; fixed == 0 means cell is not fixed
- * Initializes as non fixed cell.
+ * Returns the amount of bytes a bitset of one bit per cell of a board_size x board_size board takes.
  */
-void createCell(Cell* cell,int val){
-	cell->value = val;
-	cell->isFixed = 0;
-	cell->isError = 0;
-	cell->options = NULL;
-	cell->is_options_on = 0;
+int cell_bitset_size(int board_size){
+	return (board_size * board_size + 7) / 8;
 }
 
 /*
@@ -33,9 +28,9 @@ void createCell(Cell* cell,int val){
  * Returns a pointer to a Board struct, with the current game board and solution board set to default (all zeros).
  */
 Board* create_blank_board(int blockCols, int blockRows){
-	int i, j;
+	int i;
 	Board* board;
-	Cell** current;
+	int num_cells;
 
 	if((board = (Board*) malloc(sizeof(Board))) == NULL){
 		fprintf(stderr,"%s",MALLOC_ERROR);
@@ -45,57 +40,63 @@ Board* create_blank_board(int blockCols, int blockRows){
 	board->block_cols = blockCols;
 	board->board_size = blockCols*blockRows;
 	board->num_empty_cells_current = board->board_size*board->board_size;
+	board->num_errors = 0;
 
 
 
-	if((current = (Cell**) malloc(board->board_size*sizeof(Cell*))) == NULL){
+	/*values, then the fixed bitset, then the error bitset, all in one block (all empty and unmarked)*/
+	num_cells = board->board_size*board->board_size;
+	board->values = (unsigned char*) calloc(num_cells + 2*cell_bitset_size(board->board_size), sizeof(unsigned char));
+	if(board->values == NULL){
 		fprintf(stderr,"%s",MALLOC_ERROR);
 		free(board);
 		exit(0);
 	}
+	board->fixed = board->values + num_cells;
+	board->errors = board->fixed + cell_bitset_size(board->board_size);
+
+	board->rows_used = (ValueMask*) malloc(board->board_size*sizeof(ValueMask));
+	board->cols_used = (ValueMask*) malloc(board->board_size*sizeof(ValueMask));
+	board->blocks_used = (ValueMask*) malloc(board->board_size*sizeof(ValueMask));
+	if(!board->rows_used || !board->cols_used || !board->blocks_used){
+		fprintf(stderr,"%s",MALLOC_ERROR);
+		exit(0);
+	}
+	board->rows_count = (int*) calloc(board->board_size*board->board_size, sizeof(int));
+	board->cols_count = (int*) calloc(board->board_size*board->board_size, sizeof(int));
+	board->blocks_count = (int*) calloc(board->board_size*board->board_size, sizeof(int));
+	if(!board->rows_count || !board->cols_count || !board->blocks_count){
+		fprintf(stderr,"%s",MALLOC_ERROR);
+		exit(0);
+	}
 	for(i = 0; i < board->board_size; i++){
-		current[i] = (Cell*) malloc(board->board_size*sizeof(Cell));
-		if(current[i] == NULL){
-			fprintf(stderr,"%s",MALLOC_ERROR);
-			free(board);
-			exit(0);
-		}
-		for(j = 0; j < board->board_size; j++){
-			createCell(&current[i][j],0);
-		}
+		mask_clear(&board->rows_used[i]);
+		mask_clear(&board->cols_used[i]);
+		mask_clear(&board->blocks_used[i]);
 	}
-	board->current_board = current;
 
 	board->turns = initialize_turn_list();
+	board->version = 0;
+	board->known_solution = NULL;
+	board->known_solution_version = 0;
 
 	return board;
 }
 
-/*
- * Destroys properly a given game board, freeing all allocated resources.
- */
-void destroy_game_board(Cell** board, int size){
-	int i, j;
-	for(i = 0; i < size; i++){
-		for(j = 0; j < size; j++){
-			/*printf("   now checking cell <%d,%d>\n",j+1,i+1);*/
-			if((&(board[i][j]) != NULL) && (board[i][j].is_options_on == 1)){
-				/*printf("    now freeing <%d,%d> options array\n",j+1,i+1);*/
-				free(board[i][j].options);
-			}
-		}
-		free(board[i]);
-	}
-	free(board);
-}
-
 /*
  * Destroys properly a given Board, freeing all allocated resources.
  */
 void destroyBoard(Board* b){
-	if(b != NULL && b->current_board != NULL){
-		destroy_game_board(b->current_board, b->board_size);;
+	if(b != NULL && b->values != NULL){
+		free(b->values);
 		destroy_turn_list(b->turns);
+		free(b->rows_used);
+		free(b->cols_used);
+		free(b->blocks_used);
+		free(b->rows_count);
+		free(b->cols_count);
+		free(b->blocks_count);
+		free(b->known_solution);
 		free(b);
 	}
 }
@@ -104,26 +105,30 @@ void destroyBoard(Board* b){
 /*
  * Prints a single cell, acording to the sudoku board format and the status of the cell.
  */
-void printCell(Cell* c){
+void printCell(Board* b, int row, int col){
+	int value = get_cell_value(b, row, col);
+	int is_fixed = is_cell_fixed(b, row, col);
+	int is_error = is_cell_error(b, row, col);
 
-	if( (c->isFixed == 0) && (c->isError == 0 || (current_mode == SOLVE_MODE && mark_errors == 0)) && (c->value != 0) )
-		printf(" %2d ",c->value);
+	if( (is_fixed == 0) && (is_error == 0 || (current_mode == SOLVE_MODE && mark_errors == 0)) && (value != 0) )
+		printf(" %2d ",value);
 	else
-		if(c->value != 0 && c->isFixed == 1)
-			printf(" %2d.",c->value);
+		if(value != 0 && is_fixed == 1)
+			printf(" %2d.",value);
 		else
-			if(c->value != 0 && c->isError == 1 && (current_mode == EDIT_MODE || mark_errors == 1))
-				printf(" %2d*",c->value);
+			if(value != 0 && is_error == 1 && (current_mode == EDIT_MODE || mark_errors == 1))
+				printf(" %2d*",value);
 			else
 				printf("    ");
 }
 
+/*
+ * Prints the isError flag of every cell of the given board, and the amount of erroneous cells.
+ */
 void printIsError(Board* b){
 		int i, j;
-		Cell** board;
 		char* sep_row;
 		int total_row_length = (4* b->board_size) + b->block_rows + 1;
-		board = b->current_board;
 
 		sep_row = (char*) malloc((total_row_length + 2)*sizeof(char));
 		for( i = 0; i < total_row_length; i++ ){
@@ -139,11 +144,12 @@ void printIsError(Board* b){
 			for( j = 0; j < b->board_size; j++){
 				if( j % b->block_cols == 0 )
 					printf("|");
-				printf("  %d ",board[i][j].isError);
+				printf("  %d ",is_cell_error(b, i, j));
 			}
 			printf("|\n");
 		}
 		printf("%s",sep_row);
+		printf("erroneous cells: %d\n",b->num_errors);
 
 		free(sep_row);
 
@@ -156,10 +162,8 @@ void printIsError(Board* b){
  */
 void printBoard(Board* b){
 	int i, j;
-	Cell** board;
 	char* sep_row;
 	int total_row_length = (4* b->board_size) + (b->block_rows + 1);
-	board = b->current_board;
 
 
 	sep_row = (char*) malloc((total_row_length + 2)*sizeof(char));
@@ -181,7 +185,7 @@ void printBoard(Board* b){
 		for( j = 0; j < b->board_size; j++){
 			if( j % b->block_cols == 0 )
 				printf("|");
-			printCell(&(board[i][j]));
+			printCell(b, i, j);
 		}
 		printf("|\n");
 	}
@@ -192,83 +196,270 @@ void printBoard(Board* b){
 
 
 /*
- * Creates and returns a duplicate of a given game_board. (the actual matrix of cells, not Board).
+ * Creates and returns a duplicate of a given Board (including it's TurnsList, but not it's known solution).
  */
-Cell** copy_game_board(Cell** game_board, int board_size){
-	int i, j;
-	Cell** copy;
-	if(game_board == NULL)
+Board* copy_Board(Board* b){
+	Board* copy_board = snapshot_board(b);
+
+	if(copy_board == NULL)
 		return NULL;
 
-	if((copy = (Cell**) malloc(board_size*sizeof(Cell*))) == NULL){
-		fprintf(stderr,"%s",MALLOC_ERROR);
-		exit(0);
-	}
-	for(i = 0; i < board_size; i++){
-		if( (copy[i] = (Cell*) malloc(board_size*sizeof(Cell))) == NULL){
-			fprintf(stderr,"%s",MALLOC_ERROR);
-			exit(0);
-		}
-		for(j = 0; j < board_size; j++){
-			copy[i][j].value = game_board[i][j].value;
-			copy[i][j].isFixed = game_board[i][j].isFixed;
-			copy[i][j].isError = game_board[i][j].isError;
-			copy[i][j].is_options_on = 0;
-			copy[i][j].options = NULL;
-		}
-	}
-	return copy;
+	destroy_turn_list(copy_board->turns);
+	copy_board->turns = copy_turns_list(b->turns);
+
+	return copy_board;
 }
 
 /*
- * Creates and returns a duplicate of a given Board.
+ * Creates and returns a snapshot of a given Board: a duplicate of it's cells (values, fixed and error flags)
+ * and of it's used values masks and counts, with an empty TurnsList and no known solution.
+ * Meant for working copies (for solvers and such), which don't need the board's history.
  */
-Board* copy_Board_old(Board* b){
-	Board* copy_board;
+Board* snapshot_board(Board* b){
+	Board* snapshot;
+	int board_size;
+
 	if(b == NULL)
 		return NULL;
 
-	if((copy_board = (Board*) malloc(sizeof(Board))) == NULL){
-		fprintf(stderr,"%s",MALLOC_ERROR);
-		exit(0);
+	board_size = b->board_size;
+	snapshot = create_blank_board(b->block_cols,b->block_rows);
+
+	memcpy(snapshot->values, b->values, board_size * board_size + 2*cell_bitset_size(board_size));
+	memcpy(snapshot->rows_used, b->rows_used, board_size * sizeof(ValueMask));
+	memcpy(snapshot->cols_used, b->cols_used, board_size * sizeof(ValueMask));
+	memcpy(snapshot->blocks_used, b->blocks_used, board_size * sizeof(ValueMask));
+	memcpy(snapshot->rows_count, b->rows_count, board_size * board_size * sizeof(int));
+	memcpy(snapshot->cols_count, b->cols_count, board_size * board_size * sizeof(int));
+	memcpy(snapshot->blocks_count, b->blocks_count, board_size * board_size * sizeof(int));
+	snapshot->num_empty_cells_current = b->num_empty_cells_current;
+	snapshot->num_errors = b->num_errors;
+	snapshot->version = b->version;
+
+	return snapshot;
+}
+
+
+/*
+ * Returns the value of the cell at row, col (0 if it is empty).
+ */
+int get_cell_value(Board* b, int row, int col){
+	return b->values[row * b->board_size + col];
+}
+
+/*
+ * Writes value to the cell at row, col, and nothing else.
+ * (set_value_simple is the one that keeps the board's masks, counts and errors along with it)
+ */
+void write_cell_value(Board* b, int row, int col, int value){
+	b->values[row * b->board_size + col] = (unsigned char) value;
+}
+
+/*
+ * Returns 1 if the cell at row, col is fixed, 0 otherwise.
+ */
+int is_cell_fixed(Board* b, int row, int col){
+	int cell = row * b->board_size + col;
+	return (b->fixed[cell / 8] >> (cell % 8)) & 1;
+}
+
+/*
+ * Marks the cell at row, col as fixed (is_fixed == 1) or not (is_fixed == 0).
+ */
+void set_cell_fixed(Board* b, int row, int col, int is_fixed){
+	int cell = row * b->board_size + col;
+	if(is_fixed)
+		b->fixed[cell / 8] |= (unsigned char) (1 << (cell % 8));
+	else
+		b->fixed[cell / 8] &= (unsigned char) ~(1 << (cell % 8));
+}
+
+/*
+ * Returns 1 if the cell at row, col is marked as erroneous, 0 otherwise.
+ */
+int is_cell_error(Board* b, int row, int col){
+	int cell = row * b->board_size + col;
+	return (b->errors[cell / 8] >> (cell % 8)) & 1;
+}
+
+/*
+ * Returns the index of the block that the cell at row, col is in.
+ * Blocks are numbered row-major, from 0 to board_size - 1.
+ */
+int get_block_index(Board* b, int row, int col){
+	return (row / b->block_rows) * b->block_rows + (col / b->block_cols);
+}
+
+/*
+ * Units are the rows, columns and blocks of the board, numbered 0 to 3*board_size - 1:
+ * rows are 0 to board_size - 1, then columns, then blocks (by get_block_index).
+ * Puts in row, col the position of the k-th cell (0 to board_size - 1) of the given unit.
+ */
+void get_unit_cell(Board* b, int unit, int k, int* row, int* col){
+	int board_size = b->board_size;
+	if(unit < board_size){
+		*row = unit;
+		*col = k;
 	}
+	else if(unit < 2 * board_size){
+		*row = k;
+		*col = unit - board_size;
+	}
+	else{
+		unit -= 2 * board_size;
+		*row = (unit / b->block_rows) * b->block_rows + k / b->block_cols;
+		*col = (unit % b->block_rows) * b->block_cols + k % b->block_cols;
+	}
+}
 
-	copy_board->block_rows = b->block_rows;
-	copy_board->block_cols = b->block_cols;
-	copy_board->board_size = b->board_size;
-	copy_board->num_empty_cells_current = b->num_empty_cells_current;
+/*
+ * Puts in units the row, column and block units of the cell at row, col.
+ */
+void get_cell_units(Board* b, int row, int col, int* units){
+	units[0] = row;
+	units[1] = b->board_size + col;
+	units[2] = 2 * b->board_size + get_block_index(b, row, col);
+}
 
-	copy_board->current_board = copy_game_board(b->current_board,b->board_size);
-	copy_board->turns = copy_turns_list(b->turns);
+/*
+ * Updates the value counts and used values masks of the cell's row, column and block,
+ * after value was entered to the cell.
+ */
+void add_value_to_masks(Board* b, int row, int col, int value){
+	int block = get_block_index(b, row, col);
+	int board_size = b->board_size;
 
-	return copy_board;
+	if(value == 0)
+		return;
+	b->rows_count[row * board_size + value - 1]++;
+	b->cols_count[col * board_size + value - 1]++;
+	b->blocks_count[block * board_size + value - 1]++;
+	mask_add(&b->rows_used[row], value);
+	mask_add(&b->cols_used[col], value);
+	mask_add(&b->blocks_used[block], value);
 }
 
 /*
- * Creates and returns a duplicate of a given Board.
+ * Updates the value counts and used values masks of the cell's row, column and block,
+ * after value was removed from the cell.
+ * A value stays in a unit's mask if another cell in the unit still has it.
  */
-Board* copy_Board(Board* b){
-	Board* copy_board;
-	int row, col;
+void remove_value_from_masks(Board* b, int row, int col, int value){
+	int block = get_block_index(b, row, col);
 	int board_size = b->board_size;
 
-	if(b == NULL)
-		return NULL;
+	if(value == 0)
+		return;
+	if(--b->rows_count[row * board_size + value - 1] == 0)
+		mask_remove(&b->rows_used[row], value);
+	if(--b->cols_count[col * board_size + value - 1] == 0)
+		mask_remove(&b->cols_used[col], value);
+	if(--b->blocks_count[block * board_size + value - 1] == 0)
+		mask_remove(&b->blocks_used[block], value);
+}
 
-	copy_board = create_blank_board(b->block_cols,b->block_rows);
+/*
+ * Marks the cell at row, col as erroneous (is_error == 1) or not (is_error == 0),
+ * keeping the board's count of erroneous cells.
+ */
+void set_cell_error(Board* b, int row, int col, int is_error){
+	int cell = row * b->board_size + col;
 
+	if(is_cell_error(b, row, col) != is_error){
+		b->num_errors += is_error ? 1 : -1;
+		b->errors[cell / 8] ^= (unsigned char) (1 << (cell % 8));
+	}
+}
 
-	for(row = 0; row < board_size; row++){
-		for(col = 0; col < board_size; col++){
-			set_value_simple(copy_board, row, col, b->current_board[row][col].value);
-			/*copy_board->current_board[row][col].isError = b->current_board[row][col].isError;*/
-			copy_board->current_board[row][col].isFixed = b->current_board[row][col].isFixed;
-			}
-		}
-	/*copy_board->num_empty_cells_current = b->num_empty_cells_current;*/
+/*
+ * Returns 1 if another cell in the row, column or block of the cell at row, col
+ * has the cell's value, 0 otherwise (or if the cell is empty).
+ */
+int is_value_repeated(Board* b, int row, int col){
+	int board_size = b->board_size;
+	int value = b->values[row * board_size + col];
 
-	copy_board->turns = copy_turns_list(b->turns);
+	if(value == 0)
+		return 0;
+	return b->rows_count[row * board_size + value - 1] > 1 ||
+			b->cols_count[col * board_size + value - 1] > 1 ||
+			b->blocks_count[get_block_index(b, row, col) * board_size + value - 1] > 1;
+}
 
-	return copy_board;
+/*
+ * Puts in candidates all values that no other cell in the cell's row, column or block has.
+ * (if the cell itself has a value, that value is not a candidate)
+ */
+void get_cell_candidates(Board* b, int row, int col, ValueMask* candidates){
+	ValueMask full;
+	ValueMask* row_used = &b->rows_used[row];
+	ValueMask* col_used = &b->cols_used[col];
+	ValueMask* block_used = &b->blocks_used[get_block_index(b, row, col)];
+
+	mask_fill(&full, b->board_size);
+	mask_candidates(candidates, NULL, &row_used, &col_used, &block_used, &full, 1);
+}
+
+/*
+ * Puts in candidates[col] the candidates (as get_cell_candidates) of every cell in the given row,
+ * in a single pass of the mask kernels. If counts is not NULL, puts their amounts in counts[col].
+ */
+void get_row_candidates(Board* b, int row, ValueMask* candidates, int* counts){
+	ValueMask full;
+	ValueMask* rows[MAX_MASK_VALUES];
+	ValueMask* cols[MAX_MASK_VALUES];
+	ValueMask* blocks[MAX_MASK_VALUES];
+	int col;
+
+	for(col = 0; col < b->board_size; col++){
+		rows[col] = &b->rows_used[row];
+		cols[col] = &b->cols_used[col];
+		blocks[col] = &b->blocks_used[get_block_index(b, row, col)];
+	}
+	mask_fill(&full, b->board_size);
+	mask_candidates(candidates, counts, rows, cols, blocks, &full, b->board_size);
 }
 
+/*
+ * Keeps the values of the given solved board as the known solution of b (they must have the same size),
+ * stamped with b's current version.
+ */
+void set_known_solution(Board* b, Board* solved){
+	int row, col;
+	int board_size = b->board_size;
+
+	if(b->known_solution == NULL){
+		b->known_solution = (int*) malloc(board_size * board_size * sizeof(int));
+		if(b->known_solution == NULL){
+			fprintf(stderr,"%s",MALLOC_ERROR);
+			exit(0);
+		}
+	}
+	for(row = 0; row < board_size; row++)
+		for(col = 0; col < board_size; col++)
+			b->known_solution[row * board_size + col] = get_cell_value(solved, row, col);
+	b->known_solution_version = b->version;
+}
+
+/*
+ * Returns 1 if b has a known solution that is valid for it's current version, 0 otherwise.
+ */
+int has_known_solution(Board* b){
+	return b->known_solution != NULL && b->known_solution_version == b->version;
+}
+
+/*
+ * Called after the cell at row, col was changed to value (and b's version was advanced).
+ * The known solution stays valid if the cell was emptied or was set to it's value in the solution,
+ * and is dropped if the change contradicts it.
+ */
+void update_known_solution(Board* b, int row, int col, int value){
+	if(b->known_solution == NULL || b->known_solution_version + 1 != b->version)
+		return;
+	if(value == 0 || b->known_solution[row * b->board_size + col] == value)
+		b->known_solution_version = b->version;
+	else{
+		free(b->known_solution);
+		b->known_solution = NULL;
+	}
+}
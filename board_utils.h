@@ -8,48 +8,55 @@
 #define BOARD_UTILS_H_
 
 #include "linked_list.h"
+#include "bitmask.h"
 
 #define MALLOC_ERROR "Error: malloc has failed\nNow exiting game"
 
-/*
- * Structure: Cell
- * 		Used to represent a cell in the board.
- *
- * 		value: an integer with the cell's current valuel
- * 		isFixed: represents if the cell's value is fixed or not. 1 means it's fixed, 0 means it's not.
- * 		isError: represents if the cell's current value creates an error regarding another cell in the board.
- * 		options: an int array that can save all valid options for a cell when neede.
- * 				 the 0 index saves how many options there are.
- * 		is_options_on: binary indicator if the *options array is in use and need freeing if destroyed.
- */
-typedef struct cell_t{
-	int value;
-	int isFixed;
-	int isError;
-	int* options;
-	int is_options_on;
-
-} Cell;
-
-
 /*
  * Structure: Board
  * 		Represents a sudoku board.
  *
- * 		current_board: a 2D Cell array, representing the state of the actual board the user tries to solve.
+ * 		The cells of the board the user tries to solve are kept by row * board_size + col, in one allocation
+ * 		(that values points to), and are read and changed with the cell accessors below.
+ * 		values: the value of every cell (0 if it is empty), one byte each.
+ * 		fixed: a bitset of the fixed cells (right after values).
+ * 		errors: a bitset of the cells currently marked as erroneous (right after fixed).
  * 		board_size: the dimension of the game board - amount of rows and of columns.
  * 		block_rows: the amount of rows in one block.
  * 		block_cols: the amount of columns in one block.
- * 		num_empty_cells_current:  the amount of empty cells the current_board has at given time.
+ * 		num_empty_cells_current:  the amount of empty cells the board has at given time.
+ * 		num_errors: the amount of cells currently marked as erroneous.
  * 		turns:  A TurnsList representing all moves done on the board (for use of undo/redo).
+ * 		rows_used: for each row, a mask of the values currently in it.
+ * 		cols_used: for each column, a mask of the values currently in it.
+ * 		blocks_used: for each block (by get_block_index), a mask of the values currently in it.
+ * 		rows_count: for each row and value, the amount of cells in the row that have it (at row * board_size + value - 1).
+ * 		cols_count: the same as rows_count, for each column.
+ * 		blocks_count: the same as rows_count, for each block.
+ * 		version: counts the changes made to cell values, so a change can be told by it.
+ * 		known_solution: a full solution of the board (row * board_size + col), or NULL if none is known.
+ * 		known_solution_version: the version the known solution was last checked against.
+ * 		                        the known solution is valid only while it equals version.
  */
 typedef struct board_t{
-	Cell** current_board;
+	unsigned char* values;
+	unsigned char* fixed;
+	unsigned char* errors;
 	int board_size; /* number of rows and columns of game board */
 	int block_rows; /* m; number of rows in one block */
 	int block_cols; /* n; number of columns in one block */
 	int num_empty_cells_current;
+	int num_errors;
 	TurnsList* turns;
+	ValueMask* rows_used;
+	ValueMask* cols_used;
+	ValueMask* blocks_used;
+	int* rows_count;
+	int* cols_count;
+	int* blocks_count;
+	unsigned long version;
+	int* known_solution;
+	unsigned long known_solution_version;
 } Board;
 
 
@@ -60,18 +67,6 @@ typedef struct board_t{
 Board* create_blank_board(int blockRows, int blockCols);
 
 
-/*
- * Gets a pointer to a cell, and initializes it with given value.
- * fixed == 1 means cell is fixed; fixed == 0 means cell is not fixed
- * Initializes as non fixed cell.
- */
-void createCell(Cell* cell,int val);
-
-/*
- * Destroys properly a given game board, freeing all allocated resources.
- */
-void destroy_game_board(Cell** board, int size);
-
 /*
  * Destroys properly a given Board, freeing all allocated resources.
  */
@@ -84,17 +79,131 @@ void destroyBoard(Board* b);
  */
 void printBoard(Board* b);
 
+/*
+ * Prints the isError flag of every cell of the given board, and the amount of erroneous cells.
+ */
 void printIsError(Board* b);
 
 /*
- * Creates and returns a duplicate of a given game_board. (the actual matrix of cells, not Board).
+ * Creates and returns a duplicate of a given Board (including it's TurnsList, but not it's known solution).
  */
-Cell** copy_game_board(Cell** game_board, int board_size);
+Board* copy_Board(Board* b);
 
 /*
- * Creates and returns a duplicate of a given Board.
+ * Creates and returns a snapshot of a given Board: a duplicate of it's cells (values, fixed and error flags)
+ * and of it's used values masks and counts, with an empty TurnsList and no known solution.
+ * Meant for working copies (for solvers and such), which don't need the board's history.
  */
-Board* copy_Board(Board* b);
+Board* snapshot_board(Board* b);
+
+/*
+ * Returns the amount of bytes a bitset of one bit per cell of a board_size x board_size board takes.
+ */
+int cell_bitset_size(int board_size);
+
+/*
+ * Prints a single cell, acording to the sudoku board format and the status of the cell.
+ */
+void printCell(Board* b, int row, int col);
+
+/*
+ * Returns the value of the cell at row, col (0 if it is empty).
+ */
+int get_cell_value(Board* b, int row, int col);
+
+/*
+ * Writes value to the cell at row, col, and nothing else.
+ * (set_value_simple is the one that keeps the board's masks, counts and errors along with it)
+ */
+void write_cell_value(Board* b, int row, int col, int value);
+
+/*
+ * Returns 1 if the cell at row, col is fixed, 0 otherwise.
+ */
+int is_cell_fixed(Board* b, int row, int col);
+
+/*
+ * Marks the cell at row, col as fixed (is_fixed == 1) or not (is_fixed == 0).
+ */
+void set_cell_fixed(Board* b, int row, int col, int is_fixed);
+
+/*
+ * Returns 1 if the cell at row, col is marked as erroneous, 0 otherwise.
+ */
+int is_cell_error(Board* b, int row, int col);
+
+/*
+ * Returns the index of the block that the cell at row, col is in.
+ * Blocks are numbered row-major, from 0 to board_size - 1.
+ */
+int get_block_index(Board* b, int row, int col);
+
+/*
+ * Units are the rows, columns and blocks of the board, numbered 0 to 3*board_size - 1:
+ * rows are 0 to board_size - 1, then columns, then blocks (by get_block_index).
+ * Puts in row, col the position of the k-th cell (0 to board_size - 1) of the given unit.
+ */
+void get_unit_cell(Board* b, int unit, int k, int* row, int* col);
+
+/*
+ * Puts in units the row, column and block units of the cell at row, col.
+ */
+void get_cell_units(Board* b, int row, int col, int* units);
+
+/*
+ * Updates the value counts and used values masks of the cell's row, column and block,
+ * after value was entered to the cell.
+ */
+void add_value_to_masks(Board* b, int row, int col, int value);
+
+/*
+ * Updates the value counts and used values masks of the cell's row, column and block,
+ * after value was removed from the cell.
+ * A value stays in a unit's mask if another cell in the unit still has it.
+ */
+void remove_value_from_masks(Board* b, int row, int col, int value);
+
+/*
+ * Marks the cell at row, col as erroneous (is_error == 1) or not (is_error == 0),
+ * keeping the board's count of erroneous cells.
+ */
+void set_cell_error(Board* b, int row, int col, int is_error);
+
+/*
+ * Returns 1 if another cell in the row, column or block of the cell at row, col
+ * has the cell's value, 0 otherwise (or if the cell is empty).
+ */
+int is_value_repeated(Board* b, int row, int col);
+
+/*
+ * Puts in candidates all values that no other cell in the cell's row, column or block has.
+ * (if the cell itself has a value, that value is not a candidate)
+ */
+void get_cell_candidates(Board* b, int row, int col, ValueMask* candidates);
+
+/*
+ * Puts in candidates[col] the candidates (as get_cell_candidates) of every cell in the given row,
+ * in a single pass of the mask kernels. If counts is not NULL, puts their amounts in counts[col].
+ */
+void get_row_candidates(Board* b, int row, ValueMask* candidates, int* counts);
+
+/*
+ * Keeps the values of the given solved board as the known solution of b (they must have the same size),
+ * stamped with b's current version.
+ */
+void set_known_solution(Board* b, Board* solved);
+
+/*
+ * Returns 1 if b has a known solution that is valid for it's current version, 0 otherwise.
+ */
+int has_known_solution(Board* b);
+
+/*
+ * Called after the cell at row, col was changed to value (and b's version was advanced).
+ * The known solution stays valid if the cell was emptied or was set to it's value in the solution,
+ * and is dropped if the change contradicts it.
+ */
+void update_known_solution(Board* b, int row, int col, int value);
 
 
 
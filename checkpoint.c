@@ -0,0 +1,266 @@
+/*
+ * The "checkpoint" module is in charge of keeping the progress of long num_solutions counts.
+ * While a count runs, its state is written to a checkpoint file every CHECKPOINT_SECONDS seconds,
+ * and once more if the user stops it with Ctrl-C.
+ * The stack of a Search fully describes where the search is, so a checkpoint holds the counted
+ * board, the counting settings, the partial count and the stack (with the values left to try at
+ * every depth). Resuming replays the stack's choices on the board and continues from there,
+ * so a checkpoint can also be moved to another machine.
+ *
+ * The checkpoint file format:
+ * 		block_rows block_cols
+ * 		the board's values, a row per line
+ * 		propagation relabel
+ * 		num_sol nodes
+ * 		depth
+ * 		for every depth from the bottom of the stack: row col value amount_untried untried values
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+
+#include "board_utils.h"
+#include "game.h"
+#include "solver.h"
+#include "bignum.h"
+#include "parallel.h"
+#include "checkpoint.h"
+
+
+/* set by the SIGINT handler while a count runs */
+volatile sig_atomic_t stop_requested = 0;
+
+
+/*
+ * The SIGINT handler while a count runs: asks the count to stop at its next step.
+ * signal() may reset the handler once it is called (as glibc does under -ansi), so it is
+ * installed again, and a second Ctrl-C while the last checkpoint is written doesn't kill the game.
+ */
+void request_stop(int signum){
+	signal(signum, request_stop);
+	stop_requested = 1;
+}
+
+/*
+ * Writes the state of the search (created on board b) to the file at path.
+ * The file is written aside first (to path with ".tmp" added, so it's in the same directory)
+ * and then renamed, so a crash while writing keeps the last checkpoint.
+ * Returns 1 on success, 0 otherwise.
+ */
+int save_checkpoint(char* path, Board* b, Search* search){
+	FILE* file;
+	StackElem* elem;
+	int row, col, depth, value, saved;
+	char* temp_path = (char*) malloc(strlen(path) + sizeof(".tmp"));
+
+	if(temp_path == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	sprintf(temp_path, "%s.tmp", path);
+	if((file = fopen(temp_path, "w")) == NULL){
+		free(temp_path);
+		return 0;
+	}
+
+	fprintf(file, "%d %d\n", b->block_rows, b->block_cols);
+	for(row = 0; row < b->board_size; row++){
+		for(col = 0; col < b->board_size; col++)
+			fprintf(file, col == 0 ? "%d" : " %d", get_cell_value(b, row, col));
+		fprintf(file, "\n");
+	}
+	fprintf(file, "%d %d\n", search->propagation, mask_count(&search->relabel) > 0 ? 1 : 0);
+	fprintf(file, "%lu %ld\n", search->num_sol, search->nodes);
+	fprintf(file, "%d\n", search->stack->count);
+	for(depth = 0; depth < search->stack->count; depth++){
+		elem = elem_at(search->stack, depth);
+		fprintf(file, "%d %d %d %d", elem->row, elem->col, elem->value, mask_count(&search->untried[depth]));
+		value = 0;
+		while((value = mask_next(&search->untried[depth], value)) != 0)
+			fprintf(file, " %d", value);
+		fprintf(file, "\n");
+	}
+
+	if(fclose(file) != 0){
+		remove(temp_path);
+		free(temp_path);
+		return 0;
+	}
+	/*rename replaces the old checkpoint in one step, so there is always one to resume from*/
+	saved = rename(temp_path, path) == 0;
+	free(temp_path);
+	return saved;
+}
+
+/*
+ * Runs the given search (created on board b) until it finishes or the user stops it with Ctrl-C,
+ * writing checkpoints to CHECKPOINT_PATH on the way.
+ * Returns 1 if the search finished (the checkpoint file is then removed),
+ * or 0 if it was stopped (its last state is then in the checkpoint file).
+ */
+int run_with_checkpoints(Board* b, Search* search){
+	void (*previous_handler)(int);
+	time_t last_save = time(NULL);
+	long steps = 0;
+	int saved = 0;
+	int finished = 0;
+
+	stop_requested = 0;
+	previous_handler = signal(SIGINT, request_stop);
+
+	while(!stop_requested){
+		if(search_step(search) == 1){
+			finished = 1;
+			break;
+		}
+		if(++steps % CHECKPOINT_CHECK_INTERVAL == 0 && time(NULL) - last_save >= CHECKPOINT_SECONDS){
+			if(save_checkpoint(CHECKPOINT_PATH, b, search))
+				saved = 1;
+			else
+				printf("Error: failed to write the checkpoint file %s.\n", CHECKPOINT_PATH);
+			last_save = time(NULL);
+		}
+	}
+
+	if(finished){
+		if(saved)
+			remove(CHECKPOINT_PATH);
+	}
+	else{
+		if(!save_checkpoint(CHECKPOINT_PATH, b, search))
+			printf("Error: failed to write the checkpoint file %s.\n", CHECKPOINT_PATH);
+		search_unwind(search);
+	}
+	/*the handler is only given back once the last checkpoint was written*/
+	signal(SIGINT, previous_handler == SIG_ERR ? SIG_DFL : previous_handler);
+	return finished;
+}
+
+/*
+ * Counts the solutions of the board's current state as count_search does, with checkpoints.
+ * Puts the count in num_sol and returns 1, or returns 0 if the count was stopped by the user.
+ */
+int count_with_checkpoints(Board* b, int relabel, unsigned long* num_sol){
+	Search* search;
+	int finished;
+
+	last_search_nodes = 0;
+	*num_sol = 0;
+	if(check_board_errors(b) == 1)
+		return 1;
+
+	search = create_search(b, relabel);
+	finished = run_with_checkpoints(b, search);
+	*num_sol = search->num_sol;
+	last_search_nodes = search->nodes;
+	destroy_search(search);
+	return finished;
+}
+
+/*
+ * Reads the board at the begining of a checkpoint file.
+ * Returns the board, or NULL if the file doesn't start with a legal board.
+ */
+Board* load_checkpoint_board(FILE* file){
+	Board* b;
+	int block_rows, block_cols, row, col, value;
+
+	if(fscanf(file, "%d %d", &block_rows, &block_cols) != 2 || block_rows < 1 || block_cols < 1 ||
+			block_rows * block_cols > 99)
+		return NULL;
+	b = create_blank_board(block_cols, block_rows);
+	for(row = 0; row < b->board_size; row++)
+		for(col = 0; col < b->board_size; col++){
+			if(fscanf(file, "%d", &value) != 1 || value < 0 || value > b->board_size){
+				destroyBoard(b);
+				return NULL;
+			}
+			set_value_simple(b, row, col, value);
+		}
+	return b;
+}
+
+/*
+ * Reads the rest of a checkpoint file (after it's board) into a new Search on board b,
+ * replaying the saved stack. Returns the search, or NULL if the file isn't a legal checkpoint of b.
+ */
+Search* load_checkpoint_search(FILE* file, Board* b){
+	Search* search;
+	ValueMask untried;
+	int propagation, relabel, depth, num_depths;
+	int row, col, value, num_untried, untried_value, i;
+	unsigned long num_sol;
+	long nodes;
+
+	if(fscanf(file, "%d %d %lu %ld %d", &propagation, &relabel, &num_sol, &nodes, &num_depths) != 5 ||
+			num_depths < 0 || num_depths > b->num_empty_cells_current)
+		return NULL;
+
+	search = create_search(b, relabel);
+	search->propagation = propagation;
+	search->num_sol = num_sol;
+	search->nodes = nodes;
+	for(depth = 0; depth < num_depths; depth++){
+		if(fscanf(file, "%d %d %d %d", &row, &col, &value, &num_untried) != 4 ||
+				num_untried < 0 || num_untried > b->board_size){
+			destroy_search(search);
+			return NULL;
+		}
+		mask_clear(&untried);
+		for(i = 0; i < num_untried; i++){
+			if(fscanf(file, "%d", &untried_value) != 1 || untried_value < 1 || untried_value > b->board_size){
+				destroy_search(search);
+				return NULL;
+			}
+			mask_add(&untried, untried_value);
+		}
+		if(!search_replay(search, row, col, value, &untried)){
+			destroy_search(search);
+			return NULL;
+		}
+	}
+	return search;
+}
+
+/*
+ * Continues the count saved in the checkpoint file at path, and puts the board's exact number of
+ * solutions in result. If the count finishes and path is CHECKPOINT_PATH, the file is removed.
+ * For use of the RESUME command.
+ * Returns 1 if the count finished, 0 if it was stopped again by the user
+ * and -1 if the file could not be read as a checkpoint.
+ */
+int resume_count(char* path, BigNum* result){
+	FILE* file;
+	Board* b;
+	Search* search = NULL;
+	int finished;
+
+	if((file = fopen(path, "r")) == NULL){
+		printf("Error: failed to open checkpoint file at the path you have given -\n%s\n", path);
+		return -1;
+	}
+	if((b = load_checkpoint_board(file)) != NULL && check_board_errors(b) == 0)
+		search = load_checkpoint_search(file, b);
+	fclose(file);
+	if(search == NULL){
+		printf("Error: File is not a legal num_solutions checkpoint.\n");
+		if(b != NULL)
+			destroyBoard(b);
+		return -1;
+	}
+
+	finished = run_with_checkpoints(b, search);
+	if(finished && strcmp(path, CHECKPOINT_PATH) == 0)
+		/*the checkpoint resumed from is of a finished count now*/
+		remove(CHECKPOINT_PATH);
+	bignum_set(result, search->num_sol);
+	if(mask_count(&search->relabel) > 0)
+		multiply_by_relabellings(b, result);
+	last_search_nodes = search->nodes;
+	destroy_search(search);
+	destroyBoard(b);
+	return finished;
+}
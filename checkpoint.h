@@ -0,0 +1,55 @@
+/*
+ * The "checkpoint" module is in charge of keeping the progress of long num_solutions counts.
+ * While a count runs, its state is written to a checkpoint file every CHECKPOINT_SECONDS seconds,
+ * and once more if the user stops it with Ctrl-C.
+ * The stack of a Search fully describes where the search is, so a checkpoint holds the counted
+ * board, the counting settings, the partial count and the stack (with the values left to try at
+ * every depth). Resuming replays the stack's choices on the board and continues from there,
+ * so a checkpoint can also be moved to another machine.
+ */
+
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+#include "board_utils.h"
+#include "solver.h"
+#include "bignum.h"
+
+#define CHECKPOINT_PATH "num_solutions.checkpoint"
+#define CHECKPOINT_SECONDS 60
+/* amount of search steps between checks of the clock */
+#define CHECKPOINT_CHECK_INTERVAL 4096
+
+
+/*
+ * Writes the state of the search (created on board b) to the file at path.
+ * The file is written aside first (to path with ".tmp" added, so it's in the same directory)
+ * and then renamed, so a crash while writing keeps the last checkpoint.
+ * Returns 1 on success, 0 otherwise.
+ */
+int save_checkpoint(char* path, Board* b, Search* search);
+
+/*
+ * Runs the given search (created on board b) until it finishes or the user stops it with Ctrl-C,
+ * writing checkpoints to CHECKPOINT_PATH on the way.
+ * Returns 1 if the search finished (the checkpoint file is then removed),
+ * or 0 if it was stopped (its last state is then in the checkpoint file).
+ */
+int run_with_checkpoints(Board* b, Search* search);
+
+/*
+ * Counts the solutions of the board's current state as count_search does, with checkpoints.
+ * Puts the count in num_sol and returns 1, or returns 0 if the count was stopped by the user.
+ */
+int count_with_checkpoints(Board* b, int relabel, unsigned long* num_sol);
+
+/*
+ * Continues the count saved in the checkpoint file at path, and puts the board's exact number of
+ * solutions in result. If the count finishes and path is CHECKPOINT_PATH, the file is removed.
+ * For use of the RESUME command.
+ * Returns 1 if the count finished, 0 if it was stopped again by the user
+ * and -1 if the file could not be read as a checkpoint.
+ */
+int resume_count(char* path, BigNum* result);
+
+#endif /* CHECKPOINT_H_ */
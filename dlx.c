@@ -0,0 +1,366 @@
+/*
+ * The "dlx" module counts the solutions of a board with Dancing Links (Algorithm X),
+ * treating sudoku as an exact cover problem.
+ * Each matrix row is an option "value v in cell <row,col>", and each matrix column is a
+ * constraint that has to be covered exactly once: every cell has a value, and every row,
+ * column and block has every value.
+ * The matrix of a block geometry is built once, and is returned to its full state
+ * at the end of every count, so the next count on the same geometry can reuse it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "game.h"
+#include "board_utils.h"
+#include "solver.h"
+#include "dlx.h"
+
+
+/* the matrix of the last geometry counted */
+DlxMatrix* cached_matrix = NULL;
+
+
+/*
+ * Returns the first node of the option "value in cell <row,col>".
+ * Its 4 nodes are the cell, row, column and block constraints, in that order.
+ */
+int option_node(DlxMatrix* mx, int row, int col, int value){
+	int option = (row * mx->board_size + col) * mx->board_size + (value - 1);
+	return 1 + mx->num_columns + 4 * option;
+}
+
+/*
+ * Adds node at the bottom of the column with the given header.
+ */
+void append_to_column(DlxMatrix* mx, int header, int node){
+	mx->column[node] = header;
+	mx->down[node] = header;
+	mx->up[node] = mx->up[header];
+	mx->down[mx->up[header]] = node;
+	mx->up[header] = node;
+	mx->size[header]++;
+}
+
+/*
+ * Creates the exact cover matrix for boards with the given block geometry.
+ */
+DlxMatrix* create_dlx_matrix(int block_rows, int block_cols){
+	DlxMatrix* mx;
+	int board_size = block_rows * block_cols;
+	int num_cells = board_size * board_size;
+	int num_nodes;
+	int row, col, value, node, i;
+	int headers[4];
+
+	if((mx = (DlxMatrix*) malloc(sizeof(DlxMatrix))) == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	mx->block_rows = block_rows;
+	mx->block_cols = block_cols;
+	mx->board_size = board_size;
+	mx->num_columns = 4 * num_cells;
+	num_nodes = 1 + mx->num_columns + 4 * num_cells * board_size;
+
+	mx->left = (int*) malloc(num_nodes * sizeof(int));
+	mx->right = (int*) malloc(num_nodes * sizeof(int));
+	mx->up = (int*) malloc(num_nodes * sizeof(int));
+	mx->down = (int*) malloc(num_nodes * sizeof(int));
+	mx->column = (int*) malloc(num_nodes * sizeof(int));
+	mx->size = (int*) calloc(1 + mx->num_columns, sizeof(int));
+	mx->choice = (int*) malloc(num_cells * sizeof(int));
+	mx->given = (int*) malloc(num_cells * sizeof(int));
+	if(!mx->left || !mx->right || !mx->up || !mx->down || !mx->column ||
+			!mx->size || !mx->choice || !mx->given){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+
+	/*the root and the column headers, in one circular list*/
+	for(i = 0; i <= mx->num_columns; i++){
+		mx->left[i] = (i == 0) ? mx->num_columns : i - 1;
+		mx->right[i] = (i == mx->num_columns) ? 0 : i + 1;
+		mx->up[i] = i;
+		mx->down[i] = i;
+		mx->column[i] = i;
+	}
+
+	/*an option for every value in every cell*/
+	for(row = 0; row < board_size; row++)
+		for(col = 0; col < board_size; col++)
+			for(value = 1; value <= board_size; value++){
+				headers[0] = 1 + row * board_size + col;
+				headers[1] = 1 + num_cells + row * board_size + (value - 1);
+				headers[2] = 1 + 2 * num_cells + col * board_size + (value - 1);
+				headers[3] = 1 + 3 * num_cells +
+						((row / block_rows) * block_rows + col / block_cols) * board_size + (value - 1);
+				node = option_node(mx, row, col, value);
+				for(i = 0; i < 4; i++){
+					mx->left[node + i] = node + (i + 3) % 4;
+					mx->right[node + i] = node + (i + 1) % 4;
+					append_to_column(mx, headers[i], node + i);
+				}
+			}
+	return mx;
+}
+
+/*
+ * Destroys properly a given DlxMatrix, freeing all allocated resources.
+ */
+void destroy_dlx_matrix(DlxMatrix* mx){
+	free(mx->left);
+	free(mx->right);
+	free(mx->up);
+	free(mx->down);
+	free(mx->column);
+	free(mx->size);
+	free(mx->choice);
+	free(mx->given);
+	free(mx);
+}
+
+/*
+ * Removes the column from the header list, and all options in it from their other columns.
+ */
+void cover(DlxMatrix* mx, int header){
+	int i, j;
+	mx->right[mx->left[header]] = mx->right[header];
+	mx->left[mx->right[header]] = mx->left[header];
+	for(i = mx->down[header]; i != header; i = mx->down[i])
+		for(j = mx->right[i]; j != i; j = mx->right[j]){
+			mx->down[mx->up[j]] = mx->down[j];
+			mx->up[mx->down[j]] = mx->up[j];
+			mx->size[mx->column[j]]--;
+		}
+}
+
+/*
+ * Undoes cover of the same column. Columns must be uncovered in the opposite order they were covered.
+ */
+void uncover(DlxMatrix* mx, int header){
+	int i, j;
+	for(i = mx->up[header]; i != header; i = mx->up[i])
+		for(j = mx->left[i]; j != i; j = mx->left[j]){
+			mx->size[mx->column[j]]++;
+			mx->down[mx->up[j]] = j;
+			mx->up[mx->down[j]] = j;
+		}
+	mx->right[mx->left[header]] = header;
+	mx->left[mx->right[header]] = header;
+}
+
+/*
+ * Covers the columns of all the option's nodes, other than the one at node.
+ */
+void cover_option_rest(DlxMatrix* mx, int node){
+	int j;
+	for(j = mx->right[node]; j != node; j = mx->right[j])
+		cover(mx, mx->column[j]);
+}
+
+/*
+ * Undoes cover_option_rest of the same node.
+ */
+void uncover_option_rest(DlxMatrix* mx, int node){
+	int j;
+	for(j = mx->left[node]; j != node; j = mx->left[j])
+		uncover(mx, mx->column[j]);
+}
+
+/*
+ * Returns the column that currently has the fewest options.
+ */
+int choose_column(DlxMatrix* mx){
+	int header, best = mx->right[0];
+	for(header = mx->right[best]; header != 0; header = mx->right[header])
+		if(mx->size[header] < mx->size[best]){
+			best = header;
+			if(mx->size[best] <= 1)
+				break;
+		}
+	return best;
+}
+
+/*
+ * Selects the options of all filled cells of the board, recording them in mx->given.
+ * Returns the amount of options selected. If a filled cell's option clashes with
+ * the ones selected before it, returns -1 - (amount selected).
+ */
+int select_given(DlxMatrix* mx, Board* b){
+	int row, col, i, node, header;
+	int num_given = 0;
+
+	for(row = 0; row < mx->board_size; row++)
+		for(col = 0; col < mx->board_size; col++){
+			if(get_cell_value(b, row, col) == 0)
+				continue;
+			node = option_node(mx, row, col, get_cell_value(b, row, col));
+			for(i = 0; i < 4; i++){
+				header = mx->column[node + i];
+				if(mx->right[mx->left[header]] != header)
+					return -1 - num_given;
+			}
+			cover(mx, mx->column[node]);
+			cover_option_rest(mx, node);
+			mx->given[num_given++] = node;
+		}
+	return num_given;
+}
+
+/*
+ * Undoes select_given of the given amount of options, bringing the matrix back to its full state.
+ */
+void unselect_given(DlxMatrix* mx, int num_given){
+	int node;
+	while(num_given > 0){
+		node = mx->given[--num_given];
+		uncover_option_rest(mx, node);
+		uncover(mx, mx->column[node]);
+	}
+}
+
+/*
+ * Puts in solution (by cell, row-major) the values of the options chosen in mx->choice
+ * up to the given level.
+ */
+void record_choices(DlxMatrix* mx, int level, int* solution){
+	int i, option;
+	for(i = 0; i < level; i++){
+		option = (mx->choice[i] - 1 - mx->num_columns) / 4;
+		solution[option / mx->board_size] = option % mx->board_size + 1;
+	}
+}
+
+/*
+ * Counts the exact covers of the matrix's current state, stopping once limit were found
+ * (limit <= 0 means no limit). The search simulates recursion with mx->choice as it's stack,
+ * and leaves the matrix in the state it started with.
+ * If solution is not NULL, the values the first cover gives the cells it chose are put in it.
+ */
+unsigned long dlx_search(DlxMatrix* mx, int limit, int* solution){
+	int level = 0;
+	unsigned long num_sol = 0;
+	int descending = 1;
+	int header, node;
+
+	while(1){
+		if(descending){
+			if(mx->right[0] == 0){
+				/*all constraints are covered*/
+				if(num_sol == 0 && solution != NULL)
+					record_choices(mx, level, solution);
+				num_sol++;
+				descending = 0;
+				if(limit > 0 && num_sol >= (unsigned long) limit)
+					break;
+				continue;
+			}
+			header = choose_column(mx);
+			if(mx->size[header] == 0){
+				descending = 0;
+				continue;
+			}
+			cover(mx, header);
+			node = mx->down[header];
+		}
+		else{
+			/*backtracking: moving the deepest choice to the next option in its column*/
+			if(level == 0)
+				break;
+			level--;
+			node = mx->choice[level];
+			uncover_option_rest(mx, node);
+			node = mx->down[node];
+			if(node == mx->column[node]){
+				/*no options left in the column*/
+				uncover(mx, node);
+				continue;
+			}
+			descending = 1;
+		}
+		mx->choice[level++] = node;
+		cover_option_rest(mx, node);
+	}
+
+	/*when stopped at the limit, undoing the choices still made*/
+	while(level > 0){
+		node = mx->choice[--level];
+		uncover_option_rest(mx, node);
+		uncover(mx, mx->column[node]);
+	}
+	return num_sol;
+}
+
+/*
+ * Counts the solutions of the board with the matrix of it's geometry (built if needed),
+ * as dlx_search does with the given limit and solution.
+ */
+unsigned long dlx_count_board(Board* b, int limit, int* solution){
+	int num_given;
+	unsigned long num_sol = 0;
+
+	if(cached_matrix == NULL || cached_matrix->block_rows != b->block_rows ||
+			cached_matrix->block_cols != b->block_cols){
+		dlx_free_cache();
+		cached_matrix = create_dlx_matrix(b->block_rows, b->block_cols);
+	}
+
+	num_given = select_given(cached_matrix, b);
+	if(num_given >= 0)
+		num_sol = dlx_search(cached_matrix, limit, solution);
+	else
+		num_given = -1 - num_given;
+	unselect_given(cached_matrix, num_given);
+	return num_sol;
+}
+
+/*
+ * Functions recieves a board, and returns the number of possible solutions for
+ * the board's current state, using Dancing Links.
+ * Stops once limit solutions were found (limit <= 0 means no limit).
+ */
+unsigned long dlx_num_solutions(Board* b, int limit){
+	if(check_board_errors(b) == 1)
+		return 0;
+	return dlx_count_board(b, limit, NULL);
+}
+
+/*
+ * Uses Dancing Links to try and find a solution to the given board.
+ * If a solution is found, returns 1. If there is no solution, returns -1.
+ * When given save_solution as 1, the found solution (if exists) is saved on the given board.
+ */
+int dlx_find_solution(Board* b, int save_solution){
+	int* solution;
+	int row, col;
+	int board_size = b->board_size;
+	int found;
+
+	if(check_board_errors(b) == 1)
+		return -1;
+
+	solution = (int*) malloc(board_size * board_size * sizeof(int));
+	if(solution == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	found = dlx_count_board(b, 1, solution) == 1;
+	if(found && save_solution)
+		for(row = 0; row < board_size; row++)
+			for(col = 0; col < board_size; col++)
+				if(get_cell_value(b, row, col) == 0)
+					set_value_simple(b, row, col, solution[row * board_size + col]);
+	free(solution);
+	return found ? 1 : -1;
+}
+
+/*
+ * Frees the matrix kept for the last geometry counted, if there is one.
+ */
+void dlx_free_cache(){
+	if(cached_matrix != NULL){
+		destroy_dlx_matrix(cached_matrix);
+		cached_matrix = NULL;
+	}
+}
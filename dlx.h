@@ -0,0 +1,68 @@
+/*
+ * The "dlx" module counts the solutions of a board with Dancing Links (Algorithm X),
+ * treating sudoku as an exact cover problem.
+ * Each matrix row is an option "value v in cell <row,col>", and each matrix column is a
+ * constraint that has to be covered exactly once: every cell has a value, and every row,
+ * column and block has every value.
+ * The matrix of a block geometry is built once, and is returned to its full state
+ * at the end of every count, so the next count on the same geometry can reuse it.
+ */
+
+#ifndef DLX_H_
+#define DLX_H_
+
+#include "board_utils.h"
+
+
+/*
+ * Structure: DlxMatrix
+ * 		The sparse exact cover matrix of one block geometry, as toroidal doubly linked lists.
+ * 		Nodes are kept in arrays and are identified by their index:
+ * 		node 0 is the root, nodes 1 to num_columns are the column headers,
+ * 		and every option has 4 nodes after them (one for each of its constraints).
+ *
+ * 		block_rows, block_cols: the geometry the matrix was built for.
+ * 		board_size: the dimension of the boards of that geometry.
+ * 		num_columns: the amount of constraints (4 * board_size^2).
+ * 		left, right, up, down: the links of every node.
+ * 		column: for every node, the header node of its column.
+ * 		size: for every column header, the amount of options currently in its column.
+ * 		choice: for every depth of the search, the option node chosen in it.
+ * 		given: the option nodes selected for the filled cells of the counted board.
+ */
+typedef struct dlx_matrix_t{
+	int block_rows;
+	int block_cols;
+	int board_size;
+	int num_columns;
+	int* left;
+	int* right;
+	int* up;
+	int* down;
+	int* column;
+	int* size;
+	int* choice;
+	int* given;
+} DlxMatrix;
+
+
+/*
+ * Functions recieves a board, and returns the number of possible solutions for
+ * the board's current state, using Dancing Links.
+ * Stops once limit solutions were found (limit <= 0 means no limit).
+ */
+unsigned long dlx_num_solutions(Board* b, int limit);
+
+/*
+ * Uses Dancing Links to try and find a solution to the given board.
+ * If a solution is found, returns 1. If there is no solution, returns -1.
+ * When given save_solution as 1, the found solution (if exists) is saved on the given board.
+ */
+int dlx_find_solution(Board* b, int save_solution);
+
+/*
+ * Frees the matrix kept for the last geometry counted, if there is one.
+ */
+void dlx_free_cache();
+
+#endif /* DLX_H_ */
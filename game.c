@@ -15,6 +15,12 @@
 #include "stack.h"
 #include "linked_list.h"
 #include "gurobi_utils.h"
+#include "parallel.h"
+#include "dlx.h"
+#include "bignum.h"
+#include "checkpoint.h"
+#include "backend.h"
+#include "sat.h"
 
 
 Board* board = NULL;
@@ -28,21 +34,24 @@ Board* board = NULL;
 void INIT_Mode_print(){
 	printf("Game is now in INIT mode.\n");
 	printf("In this mode you may use the following commands:\n");
-	printf("    solve, edit or exit\n");
+	printf("    solve, edit, resume or exit\n");
 }
 
 void SOLVE_Mode_print(){
 	printf("Game is now in SOLVE mode.\n");
 	printf("In this mode you may use the following commands:\n");
 	printf("    solve, edit, print_board, mark_errors, set, validate, undo,\n");
-	printf("    redo, save, hint, autofill, num_solutions, reset or exit\n");
+	printf("    redo, save, hint, autofill, autofill_all, num_solutions,\n");
+	printf("    num_solutions_upto, threads, backend, propagation,\n");
+	printf("    symmetry, resume, reset or exit\n");
 }
 
 void EDIT_Mode_print(){
 	printf("Game is now in EDIT mode.\n");
 	printf("In this mode you may use the following commands:\n");
 	printf("    solve, edit, print_board, set, validate, undo, redo,\n");
-	printf("    save, num_solutions, generate, reset or exit\n");
+	printf("    save, num_solutions, num_solutions_upto, threads, backend,\n");
+	printf("    propagation, symmetry, resume, generate, reset or exit\n");
 }
 
 /*
@@ -92,16 +101,20 @@ int check_full_board(Board* b, int to_print){
  * Function receives a board, a cell's row&col and a value;
  * The function inserts the value in the cell, without any checks.
  * Also marks or unmarks errors appropriately.
- * num_empty_cells is updated appropriately.
+ * num_empty_cells is updated appropriately, and so is the board's version (and known solution).
  */
 void set_value_simple(Board* b, int row, int col, int inserted_val){
-	if(inserted_val == 0 && b->current_board[row][col].value != 0)
+	if(inserted_val == 0 && get_cell_value(b, row, col) != 0)
 		b->num_empty_cells_current++;
-	if(inserted_val != 0 && b->current_board[row][col].value == 0)
+	if(inserted_val != 0 && get_cell_value(b, row, col) == 0)
 		b->num_empty_cells_current--;
 
-	b->current_board[row][col].value = inserted_val;
+	remove_value_from_masks(b, row, col, get_cell_value(b, row, col));
+	write_cell_value(b, row, col, inserted_val);
+	add_value_to_masks(b, row, col, inserted_val);
 	mark_erroneous_cells(b, row, col);
+	b->version++;
+	update_known_solution(b, row, col, inserted_val);
 }
 
 /*
@@ -111,7 +124,6 @@ void set_value_simple(Board* b, int row, int col, int inserted_val){
  * If also the board is now full - prints that the user has solved the puzzle.
  */
 void set(Board* b, int col, int row, int inserted_val) {
-	Cell** game_board = b->current_board;
 	MovesList* moves = initialize_move_list();
 	int board_size = b->board_size;
 	TurnsList* turns = b->turns;
@@ -128,12 +140,12 @@ void set(Board* b, int col, int row, int inserted_val) {
 			printf("Error: Invalid Command - The inserted value (third) paramater is out of the range 1-%d.\n",board_size);
 			return;
 	}
-	if(current_mode == SOLVE_MODE && game_board[row][col].isFixed == 1) {
+	if(current_mode == SOLVE_MODE && is_cell_fixed(b, row, col) == 1) {
 		printf("Error: You can't change a fixed cell in Solve Mode.\n");
 		return;
 	}
 
-	add_move(moves, row, col, game_board[row][col].value, inserted_val);
+	add_move(moves, row, col, get_cell_value(b, row, col), inserted_val);
 	add_turn(turns, moves);
 
 	set_value_simple(b, row, col, inserted_val);
@@ -151,6 +163,9 @@ void set(Board* b, int col, int row, int inserted_val) {
  */
 void exit_game(Board* board){ /*^^^check need to destroy turns list^^^*/
 	destroyBoard(board);
+	dlx_free_cache();
+	sat_free_cache();
+	free_ilp_session();
 	printf("Now Exiting The Game\nGoodbye!");
 	exit(EXIT_SUCCESS);
 }
@@ -207,7 +222,6 @@ int load_board(char* path, enum game_mode mode){
 			}
 			/*printf("%d ",value);*/
 
-			/*printCell(b->current_board[i][j]);*/
 			if(  (fscanf(file,"%c",&is_dot) != 0) && (mode == SOLVE_MODE) && (is_dot == '.') ){
 				/*printf("marking %d,%d as fixed\n",j+1,i+1);*/
 				if(value == 0){
@@ -226,7 +240,7 @@ int load_board(char* path, enum game_mode mode){
 					fclose(file);
 					return 0;
 				}
-				board->current_board[i][j].isFixed = 1;
+				set_cell_fixed(board, i, j, 1);
 			}
 			/*printf("cell %d,%d is_dot: %c\n",j+1,i+1,is_dot);*/
 			if( is_dot != '.' &&  !isspace(is_dot) ){
@@ -240,7 +254,7 @@ int load_board(char* path, enum game_mode mode){
 			is_dot = ' ';
 			set_value_simple(board, i, j, value);
 
-			/*printf("cell %d,%d isError: %d\n",j+1,i+1,board->current_board[i][j].isError);*/
+			/*printf("cell %d,%d isError: %d\n",j+1,i+1,is_cell_error(board, i, j));*/
 		}
 	}
 	if(((m = fscanf(file,"%20s",*checker)) > 0)){
@@ -301,66 +315,191 @@ void edit(char* path){
 
 /*
  * Function that fills all cells in given board that only have one valid value.
+ * The cells are found from the board's used values masks before any of them is filled,
+ * and are then filled in place, all as a single turn.
  * Returns the number of cells that were filled.
  * For use of the AUTOFILL command.
  */
-int autofill(Board** b){
+int autofill(Board* b){
 	int i,j;
 	int num_filled = 0;
-	int* options;
+	ValueMask candidates[MAX_MASK_VALUES];
+	int counts[MAX_MASK_VALUES];
 	MovesList* moves;
-	int board_size = (*b)->board_size;
-	Board* updated_board = copy_Board(*b);
-	TurnsList* turns = updated_board->turns;
-
+	Node* move;
+	int board_size;
 
 	if(b == NULL){
 		printf("Error: There is no board to autofill.\n");
 		return -1;
 	}
+	board_size = b->board_size;
 	moves = initialize_move_list();
 
-	/*printf("num empty cells now is: %d\n",updated_board->num_empty_cells_current);*/
-	for(i = 0; i < board_size; i++)
+	/*first only recording the fills, so all options are from the board before any cell was filled*/
+	for(i = 0; i < board_size; i++){
+		get_row_candidates(b, i, candidates, counts);
 		for(j = 0; j < board_size; j++){
-			if((*b)->current_board[i][j].value == 0){
-				options = generate_options(*b,i,j,0);
-				/*printf("num options for cell %d,%d is %d\n",i,j,options[0]);*/
-				if(options[0] == 1){
-					num_filled++;
-					add_move(moves, i, j, updated_board->current_board[i][j].value, options[1]);
-					set_value_simple(updated_board,i,j,options[1]);
-					/*mark_erroneous_cells(updated_board, i, j);*/
-				}
-				free(options);
+			if(get_cell_value(b, i, j) == 0 && counts[j] == 1){
+				num_filled++;
+				add_move(moves, i, j, 0, mask_next(&candidates[j], 0));
 			}
 		}
-	/*printf("num empty cells after filling in copy is: %d\n",updated_board->num_empty_cells_current);*/
-	add_turn(turns, moves);
-	destroyBoard(*b);
-	*b = updated_board;
-	/*printf("num empty cells now is: %d\n",board->num_empty_cells_current);*/
+	}
+	for(move = moves->top; move != NULL; move = move->next)
+		set_value_simple(b, move->row, move->col, move->new_val);
+
+	add_turn(b->turns, moves);
+	return num_filled;
+}
+
+/*
+ * Fills the empty cell at row, col with value, as part of autofill_all, if value is still valid for it.
+ * The fill is added to moves, and the cell's units that aren't queued yet are added to the queue
+ * of the next round (next, with next_size units; queued marks the units in it).
+ * Returns 1 if the cell was filled, 0 otherwise.
+ */
+int fill_single(Board* b, int row, int col, int value, MovesList* moves, int* next, int* next_size, char* queued){
+	ValueMask candidates;
+	int units[3];
+	int i;
+
+	if(get_cell_value(b, row, col) != 0)
+		return 0;
+	get_cell_candidates(b, row, col, &candidates);
+	if(!mask_has(&candidates, value))
+		return 0;
+
+	add_move(moves, row, col, 0, value);
+	set_value_simple(b, row, col, value);
+	get_cell_units(b, row, col, units);
+	for(i = 0; i < 3; i++){
+		if(!queued[units[i]]){
+			queued[units[i]] = 1;
+			next[(*next_size)++] = units[i];
+		}
+	}
+	return 1;
+}
+
+/*
+ * Fills the singles of the given unit, as part of autofill_all:
+ * first every empty cell that has only one valid value (naked singles),
+ * then every value that is valid for only one empty cell of the unit (hidden singles).
+ * Cells are filled as they are found (see fill_single).
+ * Returns the number of cells that were filled.
+ */
+int fill_unit_singles(Board* b, int unit, MovesList* moves, int* next, int* next_size, char* queued){
+	ValueMask candidates;
+	int places[MAX_MASK_VALUES + 1];
+	int place_of[MAX_MASK_VALUES + 1];
+	int board_size = b->board_size;
+	int num_filled = 0;
+	int k, row, col, value;
+
+	for(k = 0; k < board_size; k++){
+		get_unit_cell(b, unit, k, &row, &col);
+		if(get_cell_value(b, row, col) != 0)
+			continue;
+		get_cell_candidates(b, row, col, &candidates);
+		if(mask_count(&candidates) == 1)
+			num_filled += fill_single(b, row, col, mask_next(&candidates, 0), moves, next, next_size, queued);
+	}
+
+	for(value = 1; value <= board_size; value++)
+		places[value] = 0;
+	for(k = 0; k < board_size; k++){
+		get_unit_cell(b, unit, k, &row, &col);
+		if(get_cell_value(b, row, col) != 0)
+			continue;
+		get_cell_candidates(b, row, col, &candidates);
+		for(value = mask_next(&candidates, 0); value != 0; value = mask_next(&candidates, value)){
+			places[value]++;
+			place_of[value] = k;
+		}
+	}
+	for(value = 1; value <= board_size; value++){
+		if(places[value] == 1){
+			get_unit_cell(b, unit, place_of[value], &row, &col);
+			num_filled += fill_single(b, row, col, value, moves, next, next_size, queued);
+		}
+	}
+	return num_filled;
+}
+
+/*
+ * Function that fills cells in given board until no cell can be filled anymore:
+ * cells that only have one valid value, and cells that are the only place in their row,
+ * column or block for a value.
+ * Works in rounds: the first one checks every unit (row, column and block), and every next
+ * round checks only the units of the cells filled in the round before it.
+ * All the cells filled are a single turn.
+ * Returns the number of cells that were filled, and puts in rounds the number of rounds that filled cells.
+ * For use of the AUTOFILL_ALL command.
+ */
+int autofill_all(Board* b, int* rounds){
+	int queue[3 * MAX_MASK_VALUES];
+	int next[3 * MAX_MASK_VALUES];
+	char queued[3 * MAX_MASK_VALUES];
+	int queue_size, next_size;
+	int num_units, i, round_filled;
+	int num_filled = 0;
+	MovesList* moves;
+
+	*rounds = 0;
+	if(b == NULL){
+		printf("Error: There is no board to autofill.\n");
+		return -1;
+	}
+	moves = initialize_move_list();
+
+	num_units = 3 * b->board_size;
+	for(i = 0; i < num_units; i++){
+		queue[i] = i;
+		queued[i] = 0;
+	}
+	queue_size = num_units;
+
+	while(queue_size > 0){
+		next_size = 0;
+		round_filled = 0;
+		for(i = 0; i < queue_size; i++)
+			round_filled += fill_unit_singles(b, queue[i], moves, next, &next_size, queued);
+		if(round_filled > 0)
+			(*rounds)++;
+		num_filled += round_filled;
+
+		for(i = 0; i < next_size; i++){
+			queue[i] = next[i];
+			queued[next[i]] = 0;
+		}
+		queue_size = next_size;
+	}
+
+	add_turn(b->turns, moves);
 	return num_filled;
 }
 
 /*
- * Function uses ILP to check if the given board has a solution
- * or not.
+ * Function checks with the chosen solver (see is_feasible in backend.h) if the given board has a
+ * solution or not. Only on the ilp backend the board's copy is autofilled first, to make the
+ * model smaller.
  * Returns 1 if a solutions was found, -1 if a no solution exists.
  * Otherwise returns 0 on errors.
  * For use of the VALIDATE command.
  */
 int validate_board(Board* board){
-	Board* b_copy = copy_Board(board);
+	Board* b_copy = snapshot_board(board);
 	int ret;
 	if(check_board_errors(b_copy) == 1){
 		printf("Error: The board has erroneous cells so no solution is possible.\n");
 		return 0;
 	}
 
-	autofill(&b_copy); /*autofilling to make ilp easier*/
+	if(solver_backend == ILP_BACKEND)
+		autofill(b_copy); /*autofilling to make ilp easier*/
 
-	ret = find_ILP_solution(b_copy,0);
+	ret = is_feasible(b_copy);
 
 	destroyBoard(b_copy);
 	return ret;
@@ -369,8 +508,10 @@ int validate_board(Board* board){
 /*
  * Function for use of hint command.
  * Receives the board, and cell col and row.
- * Checks everything is legal, and looks for a ilp solution to the board.
+ * Checks everything is legal, and looks for a solution to the board (see find_solution).
  * If there is a solution, function prints the value of solution in the cell.
+ * The solution found is kept as the board's known solution, and later hints are answered from it
+ * for as long as no change to the board contradicts it.
  */
 void cell_hint(Board* b, int col, int row){
 	Board* b_copy;
@@ -389,25 +530,28 @@ void cell_hint(Board* b, int col, int row){
 		printf("Error: The board has erroneous cells.\n");
 		return;
 	}
-	if(b->current_board[row][col].isFixed == 1){
+	if(is_cell_fixed(b, row, col) == 1){
 		printf("Error: The cell you asked a hint fot is fixed.\n");
 		return;
 	}
-	if(b->current_board[row][col].value > 0){
+	if(get_cell_value(b, row, col) > 0){
 		printf("Error: The cell you asked a hint for already has a value.\n");
 		return;
 	}
 
-	b_copy = copy_Board(b);
-	if(find_ILP_solution(b_copy,1) == 0){
+	if(!has_known_solution(b)){
+		b_copy = snapshot_board(b);
+		if(find_solution(b_copy,1) != 1){
+			destroyBoard(b_copy);
+			printf("Error: The board has no solution.\n");
+			return;
+		}
+		set_known_solution(b, b_copy);
 		destroyBoard(b_copy);
-		printf("Error: The board has no solution.\n");
-		return;
 	}
 
-	value = b_copy->current_board[row][col].value;
+	value = b->known_solution[row * board_size + col];
 	printf("Hint: You can set cell <%d,%d> to the value %d.\n",col+1,row+1,value);
-	destroyBoard(b_copy);
 	return;
 }
 
@@ -421,7 +565,7 @@ void cell_hint(Board* b, int col, int row){
 void save(char* path){
 	FILE* file;
 	int i,j;
-	Cell* cell;
+	int value;
 	int ret;
 
 	if(current_mode == EDIT_MODE){
@@ -429,15 +573,13 @@ void save(char* path){
 			printf("Error: The board currently has errors, so it can't be saved.\n");
 			return;
 		}
-		ret = validate_board(board);
-		if(ret == -1){
-			printf("Error: The board has no solution, so it can't be saved.\n");
-			return;
-		}
+		ret = count_solutions_upto(board, 2);
 		if(ret == 0){
-			printf("Error: Validation with ilp failed, so board can't be saved.\n");
+			printf("Error: The board has no solution, so it can't be saved.\n");
 			return;
 		}
+		if(ret > 1)
+			printf("Note: The saved board has more than one solution.\n");
 	}
 
 	if( (file = fopen(path,"w")) == NULL ){
@@ -448,9 +590,9 @@ void save(char* path){
 	fprintf(file,"%d %d\n", board->block_rows, board->block_cols);
 	for(i = 0; i < board->board_size; i++){
 		for(j = 0; j < board->board_size; j++){
-			cell = &(board->current_board[i][j]);
-			fprintf(file,"%d", cell->value);
-			if((current_mode == EDIT_MODE && cell->value != 0) || cell->isFixed == 1)
+			value = get_cell_value(board, i, j);
+			fprintf(file,"%d", value);
+			if((current_mode == EDIT_MODE && value != 0) || is_cell_fixed(board, i, j) == 1)
 				fprintf(file,".");
 			if(j != board->board_size - 1)
 				fprintf(file," ");
@@ -558,6 +700,9 @@ void execute_command(Command* command){
 	int inserted_val = command->params[2];
 	int binary_param = command->params[0];
 	int num_filled;
+	int rounds;
+	int ret;
+	BigNum exact_count;
 
 	switch(command->id) {
 		case SOLVE:
@@ -590,6 +735,10 @@ void execute_command(Command* command){
 				else
 					printf("     Validation failed because of an Error.\n");
 			}
+			if(num_filled != 0 && solver_backend == ILP_BACKEND)
+				printf("The ilp model took %.3f seconds of cpu time to build,"
+						" and %.3f seconds of wall clock time to solve.\n",
+						ilp_build_seconds, ilp_solve_seconds);
 			break;
 		case GENERATE:
 			num_filled = generate(board,col + 1, row + 1);
@@ -615,14 +764,94 @@ void execute_command(Command* command){
 		    break;
 		case NUM_SOLUTIONS:
 			printf("Now starting to calculate number of solutions.\nThis could take a while.\n\n");
-			printf("The number of solutions for the current board is %d\n",num_solutions(board));
+			if(current_backend()->count_all == NULL)
+				printf("%s can't count all the solutions, so counting with backtracking.\n", current_backend()->name);
+			if(!count_all_solutions(board, &exact_count)){
+				printf("Counting was stopped. It's progress was saved to %s,\n", CHECKPOINT_PATH);
+				printf("use \"resume %s\" to continue it.\n", CHECKPOINT_PATH);
+				break;
+			}
+			printf("The number of solutions for the current board is ");
+			bignum_print(&exact_count);
+			printf("\n");
+			if(solver_backend == BACKTRACK_BACKEND || current_backend()->count_all == NULL)
+				printf("The search went through %ld nodes (propagation %s, symmetry %s).\n",
+						last_search_nodes, use_propagation ? "on" : "off", use_symmetry ? "on" : "off");
+			break;
+		case NUM_SOLUTIONS_UPTO:
+			if(binary_param < 1){
+				printf("Error: Invalid Command - num_solutions_upto needs a limit of at least 1.\n");
+				break;
+			}
+			num_filled = count_solutions_upto(board, binary_param);
+			if(num_filled == binary_param)
+				printf("The current board has at least %d solutions\n", num_filled);
+			else
+				printf("The number of solutions for the current board is %d\n", num_filled);
+			break;
+		case THREADS:
+			if(binary_param < 1 || binary_param > MAX_THREADS)
+				printf("Error: Invalid Command - threads can only be used with 1-%d.\n", MAX_THREADS);
+			else{
+				num_threads = binary_param;
+				printf("num_solutions will now count with %d threads.\n", num_threads);
+			}
+			break;
+		case PROPAGATION:
+			if(binary_param > 1 || binary_param < 0)
+				printf("Error: Invalid Command - propagation can only be used with 0 (off) or 1 (on).\n");
+			else{
+				use_propagation = binary_param;
+				printf("Propagation of forced cells in the backtracking search is now %s.\n",
+						use_propagation ? "on" : "off");
+			}
+			break;
+		case RESUME:
+			printf("Now resuming the count saved in %s.\nThis could take a while.\n\n", command->path_param);
+			ret = resume_count(command->path_param, &exact_count);
+			if(ret == 0){
+				printf("Counting was stopped. It's progress was saved to %s,\n", CHECKPOINT_PATH);
+				printf("use \"resume %s\" to continue it.\n", CHECKPOINT_PATH);
+			}
+			else if(ret == 1){
+				printf("The number of solutions for the checkpoint's board is ");
+				bignum_print(&exact_count);
+				printf("\n");
+			}
+			break;
+		case BACKEND:
+			if(binary_param >= NUM_BACKENDS || binary_param < 0)
+				printf("Error: Invalid Command - backend can only be used with 0 (backtracking), 1 (ilp),"
+						" 2 (dancing links) or 3 (sat).\n");
+			else{
+				solver_backend = (backend_id) binary_param;
+				printf("validate, hint and generate will now use %s.\n", current_backend()->name);
+				printf("num_solutions will count with %s, and num_solutions_upto with %s.\n",
+						current_backend()->count_all != NULL ? current_backend()->name : "backtracking",
+						current_backend()->count_upto != NULL ? current_backend()->name : "backtracking");
+			}
+			break;
+		case SYMMETRY:
+			if(binary_param > 1 || binary_param < 0)
+				printf("Error: Invalid Command - symmetry can only be used with 0 (off) or 1 (on).\n");
+			else{
+				use_symmetry = binary_param;
+				printf("Counting by relabelling symmetry in num_solutions is now %s.\n",
+						use_symmetry ? "on" : "off");
+			}
 			break;
 		case AUTOFILL:
-			num_filled = autofill(&board);
+			num_filled = autofill(board);
 			printf("Successfully filled %d cells\n", num_filled);
 			printBoard(board);
 			check_full_board(board,1);
 			break;
+		case AUTOFILL_ALL:
+			num_filled = autofill_all(board, &rounds);
+			printf("Successfully filled %d cells in %d rounds\n", num_filled, rounds);
+			printBoard(board);
+			check_full_board(board,1);
+			break;
 		case RESET:
 			reset_board(board);
 			break;
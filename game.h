@@ -14,8 +14,17 @@ typedef enum game_mode {
 	INIT_MODE, EDIT_MODE, SOLVE_MODE
 }game_mode;
 
+/* the solvers VALIDATE, HINT, GENERATE and the solution counting commands can use (see backend.h) */
+typedef enum backend_id {
+	BACKTRACK_BACKEND, ILP_BACKEND, DLX_BACKEND, SAT_BACKEND, NUM_BACKENDS
+}backend_id;
+
 extern game_mode current_mode;
 extern int mark_errors;
+extern int num_threads; /* amount of threads num_solutions counts with */
+extern int use_propagation; /* 1 if the backtracking search fills forced cells before branching */
+extern backend_id solver_backend;
+extern int use_symmetry; /* 1 if num_solutions counts one solution of every relabelling of missing values */
 
 
 
@@ -52,14 +61,46 @@ int check_full_board(Board* b, int to_print);
 
 /*
  * Function that fills all cells in given board that only have one valid value.
+ * The cells are found from the board's used values masks before any of them is filled,
+ * and are then filled in place, all as a single turn.
  * Returns the number of cells that were filled.
  * For use of the AUTOFILL command.
  */
-int autofill(Board** board);
+int autofill(Board* board);
+
+/*
+ * Fills the empty cell at row, col with value, as part of autofill_all, if value is still valid for it.
+ * The fill is added to moves, and the cell's units that aren't queued yet are added to the queue
+ * of the next round (next, with next_size units; queued marks the units in it).
+ * Returns 1 if the cell was filled, 0 otherwise.
+ */
+int fill_single(Board* b, int row, int col, int value, MovesList* moves, int* next, int* next_size, char* queued);
+
+/*
+ * Fills the singles of the given unit, as part of autofill_all:
+ * first every empty cell that has only one valid value (naked singles),
+ * then every value that is valid for only one empty cell of the unit (hidden singles).
+ * Cells are filled as they are found (see fill_single).
+ * Returns the number of cells that were filled.
+ */
+int fill_unit_singles(Board* b, int unit, MovesList* moves, int* next, int* next_size, char* queued);
+
+/*
+ * Function that fills cells in given board until no cell can be filled anymore:
+ * cells that only have one valid value, and cells that are the only place in their row,
+ * column or block for a value.
+ * Works in rounds: the first one checks every unit (row, column and block), and every next
+ * round checks only the units of the cells filled in the round before it.
+ * All the cells filled are a single turn.
+ * Returns the number of cells that were filled, and puts in rounds the number of rounds that filled cells.
+ * For use of the AUTOFILL_ALL command.
+ */
+int autofill_all(Board* board, int* rounds);
 
 /*
- * Function uses ILP to check if the given board has a solution
- * or not.
+ * Function checks with the chosen solver (see is_feasible in backend.h) if the given board has a
+ * solution or not. Only on the ilp backend the board's copy is autofilled first, to make the
+ * model smaller.
  * Returns 1 if a solutions was found, -1 if a no solution exists.
  * Otherwise returns 0 on errors.
  * For use of the VALIDATE command.
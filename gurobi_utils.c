@@ -1,97 +1,137 @@
 /*
  * The "gurobi_utils" module is in charge of all functions that directly use Gurobi
  * for finding ilp solutions.
+ * The Gurobi environment is loaded once, on the first ilp call, and is kept until
+ * free_ilp_session is called when the game exits.
+ * The model is kept as well: it has a binary variable for every value in every cell, and is
+ * only rebuilt when the board's block geometry changes. Between calls, the board's state
+ * (sets, undos, redos, a new board...) only changes the bounds of variables, and the model
+ * is re-solved from where Gurobi left it.
  */
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 #include "gurobi_c.h"
 #include "board_utils.h"
 #include "game.h"
 #include "solver.h"
-
+#include "arena.h"
 
 
 /*
- * for ilp use.
- * Allocates a 3 dimensional int array for the need variables, with 0 values in all cells.
- * returns the array.
+ * Structure: IlpSession
+ * 		The Gurobi environment and model, kept alive between ilp calls
+ * 		(loading the environment and building the model are the most expensive parts of solving a small board).
+ * 		Kept here and not in the header, since only this module is compiled with Gurobi's headers.
+ *
+ * 		env: the environment, NULL until it is loaded successfully.
+ * 		model: the model of the current geometry, NULL if there is none.
+ * 		block_rows, block_cols, board_size: the geometry the model was built for.
+ * 		num_vars: the amount of variables in the model (board_size^3).
+ * 		arena: the memory all of the buffers below are taken from. It lives as long as the model,
+ * 		       not a single solve: it is created when the model is built, kept across every solve
+ * 		       of that geometry (solving allocates nothing), and released only with the model.
+ * 		lb, ub: the bounds every variable currently has in the model (0 or 1).
+ * 		wanted_lb, wanted_ub: the bounds every variable should have for the board being solved.
+ * 		ind, val: buffers for the indexes and new bounds of variables whose bounds change.
+ * 		sol: the variables' values in the last solution.
  */
-int*** allocate_var_indexs(int size){
-	int i, j;
-	int*** array = (int***) malloc(size * size * sizeof(int**));
-
-	for(i = 0; i < size; i++){
-		array[i] = (int**) malloc(size * sizeof(int*));
-		for(j = 0; j < size; j++){
-			array[i][j] = (int*) calloc(size, sizeof(int));
-		}
-	}
-	return array;
-}
+typedef struct ilp_session_t{
+	GRBenv* env;
+	GRBmodel* model;
+	int block_rows;
+	int block_cols;
+	int board_size;
+	int num_vars;
+	Arena* arena;
+	char* lb;
+	char* ub;
+	char* wanted_lb;
+	char* wanted_ub;
+	int* ind;
+	double* val;
+	double* sol;
+} IlpSession;
+
+IlpSession ilp_session = {NULL, NULL, 0, 0, 0, 0, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+
+/* the cpu time (in seconds, by clock()) the last ilp call spent building/updating the model, and
+ * the wall clock time (in seconds, by Gurobi's RUNTIME) it spent solving it */
+double ilp_build_seconds = 0;
+double ilp_solve_seconds = 0;
 
-/*
- *Destroys safely the var_index 3d array.
- */
-void destroy_var_indexs(int*** array, int size){
-	int i, j;
-
-	for(i = 0; i < size; i++){
-		for(j = 0; j < size; j++)
-			free(array[i][j]);
-		free(array[i]);
-	}
-	free(array);
-}
 
 /*
- * Function frees all allocated memory used in the enviroment.
- * Get's all the pointers to be freed.
+ * Returns the index of the variable of "value in cell <row,col>" in the model.
  */
-void free_resorces(GRBenv* env, GRBmodel* model, char* vtype, int*** var_indexs,
-					double* obj, int* ind, double* val, double* sol, int board_size){
-	destroy_var_indexs(var_indexs, board_size);
-	free(vtype);
-	free(obj);
-	free(ind);
-	free(val);
-	free(sol);
-	GRBfreemodel(model);
-	GRBfreeenv(env);
+int ilp_var(int board_size, int row, int col, int value){
+	return (row * board_size + col) * board_size + (value - 1);
 }
 
-
 /*
- * Function that Creates the Gurobi enviroment, with the GRBenv and GRBmodel given.
+ * Function that Creates the Gurobi enviroment, if it wasn't created by a former call.
  * Returns 1 on success, 0 on failure.
  */
-int create_env(GRBenv** env, GRBmodel** model){
+int create_env(){
 	  int       error = 0;
 
-	  /* Create environment - log file is integerLinearPrograming.log */
-	  error = GRBloadenv(env, "integerLinearPrograming.log");
-	  if (error) {
-		  printf("ERROR: %d GRBloadenv(): %s\n", error, GRBgeterrormsg(*env));
-		  return 0;
-	  }
+	  if(ilp_session.env != NULL)
+		  return 1;
 
-	  error = GRBsetintparam(*env, GRB_INT_PAR_LOGTOCONSOLE, 0);
+	  /* Create environment - log file is integerLinearPrograming.log */
+	  error = GRBloadenv(&ilp_session.env, "integerLinearPrograming.log");
 	  if (error) {
-		  printf("ERROR: %d GRBsetintattr(): %s\n", error, GRBgeterrormsg(*env));
-		  GRBfreeenv(*env);
+		  printf("ERROR: %d GRBloadenv(): %s\n", error, GRBgeterrormsg(ilp_session.env));
+		  GRBfreeenv(ilp_session.env);
+		  ilp_session.env = NULL;
 		  return 0;
 	  }
 
-	  /* Create an empty model named "mip1" */
-	  error = GRBnewmodel(*env, model, "integerLinearPrograming", 0, NULL, NULL, NULL, NULL, NULL);
+	  error = GRBsetintparam(ilp_session.env, GRB_INT_PAR_LOGTOCONSOLE, 0);
 	  if (error) {
-		  printf("ERROR: %d GRBnewmodel(): %s\n", error, GRBgeterrormsg(*env));
-		  GRBfreeenv(*env);
+		  printf("ERROR: %d GRBsetintattr(): %s\n", error, GRBgeterrormsg(ilp_session.env));
+		  GRBfreeenv(ilp_session.env);
+		  ilp_session.env = NULL;
 		  return 0;
 	  }
 	  return 1;
 }
 
+/*
+ * Frees the session's model and all buffers that belong to it, if they exist.
+ */
+void free_ilp_model(){
+	if(ilp_session.model != NULL)
+		GRBfreemodel(ilp_session.model);
+	destroy_arena(ilp_session.arena);
+
+	ilp_session.model = NULL;
+	ilp_session.block_rows = 0;
+	ilp_session.block_cols = 0;
+	ilp_session.board_size = 0;
+	ilp_session.num_vars = 0;
+	ilp_session.arena = NULL;
+	ilp_session.lb = NULL;
+	ilp_session.ub = NULL;
+	ilp_session.wanted_lb = NULL;
+	ilp_session.wanted_ub = NULL;
+	ilp_session.ind = NULL;
+	ilp_session.val = NULL;
+	ilp_session.sol = NULL;
+}
+
+/*
+ * Frees the Gurobi environment and model kept between ilp calls, if they exist.
+ */
+void free_ilp_session(){
+	free_ilp_model();
+	if(ilp_session.env != NULL)
+		GRBfreeenv(ilp_session.env);
+	ilp_session.env = NULL;
+}
+
 /*
  * add the variables to the model.
  * returns 1 on success, 0 on failure.
@@ -128,124 +168,236 @@ int add_variables(GRBenv** env, GRBmodel** model, int var_amount, double** obj,
 	return 1;
 }
 
+/*
+ * Appends to the compressed sparse row buffers (cbeg, cind) the constraint whose variables are
+ * first, first + step, ..., first + (count - 1) * step, as constraint number *num_constrs.
+ * Advances *num_constrs and *num_nz.
+ */
+void append_constraint(int* cbeg, int* cind, int* num_constrs, int* num_nz,
+		int first, int step, int count){
+	int i;
+	cbeg[(*num_constrs)++] = *num_nz;
+	for(i = 0; i < count; i++)
+		cind[(*num_nz)++] = first + i * step;
+}
+
 /*
  * Function receives all needed to add constraints to the model, for ilp.
+ * The constraints are for an empty board of the given geometry (values are given by bounds).
+ * All constraints are put in one compressed sparse row buffer, and added with a single call.
  * Returns 1 on success, o on failure.
  */
-int add_constraints(Board* board, GRBenv** env, GRBmodel** model, int var_amount,
-		 int** ind, double** val, int*** var_indexs){
+int add_constraints(GRBenv** env, GRBmodel** model, int block_rows, int block_cols){
 	int i, j, k, a, b;
-	int n = board->block_cols;
-	int m = board->block_rows;
-	int current;
-	int board_size = board->board_size;
+	int n = block_cols;
+	int m = block_rows;
+	int board_size = n * m;
+	int max_constrs = 4 * board_size * board_size;
+	int num_constrs = 0, num_nz = 0;
+	int* cbeg;
+	int* cind;
+	double* cval;
+	char* sense;
+	double* rhs;
 	int error;
-	Cell* curr_cell;
+
+	cbeg = (int*) malloc(max_constrs * sizeof(int));
+	cind = (int*) malloc(max_constrs * board_size * sizeof(int));
+	cval = (double*) malloc(max_constrs * board_size * sizeof(double));
+	sense = (char*) malloc(max_constrs * sizeof(char));
+	rhs = (double*) malloc(max_constrs * sizeof(double));
+	if(!cbeg || !cind || !cval || !sense || !rhs){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
 
 	/*Constraint 1: each cell has exactly 1 value*/
 	for(i = 0; i < board_size; i++)
-		for(j = 0; j < board_size; j++){
-			curr_cell = &(board->current_board[i][j]);
-			if(curr_cell->value == 0){
-				for(k = 0; k < curr_cell->options[0]; k++){
-					/*printf("    entered third for with option %d\n",curr_cell->options[k+1]);*/
-					(*ind)[k] = var_indexs[i][j][curr_cell->options[k+1] - 1] - 1;
-					/*printf("    ok with var_indexes. put in %d\n",(*ind)[k]);*/
-					(*val)[k] = 1;
-				}
-				error = GRBaddconstr(*model, k, *ind, *val, GRB_EQUAL, 1.0, "c1");
-				if (error) {
-					printf("ERROR %d 1st GRBaddconstr(): %s\n", error, GRBgeterrormsg(*env));
-					return 0;
-				}
-				/*printf("success in addcinstr for cell <%d,%d>\n", j+1,i+1);*/
-			}
-		}
+		for(j = 0; j < board_size; j++)
+			append_constraint(cbeg, cind, &num_constrs, &num_nz, ilp_var(board_size, i, j, 1), 1, board_size);
 
 	/*Constraint 2: each row has one of each possible value*/
 	for(i = 0; i < board_size; i++)
-		for(k = 0; k < board_size; k++){
-			current = 0;
-			for(j = 0; j < board_size; j++){
-				if(var_indexs[i][j][k] > 0){
-					(*ind)[current] = var_indexs[i][j][k] - 1;
-					(*val)[current] = 1;
-					current += 1;
-				}
-			}
-			if(current > 0){
-				error = GRBaddconstr(*model, current, *ind, *val, GRB_EQUAL, 1.0, "c2");
-				if (error) {
-					printf("ERROR %d 2nd GRBaddconstr(): %s\n", error, GRBgeterrormsg(*env));
-					return 0;
-				}
-
-			}
-		}
+		for(k = 1; k <= board_size; k++)
+			append_constraint(cbeg, cind, &num_constrs, &num_nz,
+					ilp_var(board_size, i, 0, k), board_size, board_size);
 
 	/*Constraint 3: each column has one of each possible value*/
 	for(j = 0; j < board_size; j++)
-		for(k = 0; k < board_size; k++){
-			current = 0;
-			for(i = 0; i < board_size; i++){
-				if(var_indexs[i][j][k] > 0){
-					(*ind)[current] = var_indexs[i][j][k] - 1;
-					(*val)[current] = 1;
-					current += 1;
-				}
-			}
-			if(current > 0){
-				error = GRBaddconstr(*model, current, *ind, *val, GRB_EQUAL, 1.0, "c3");
-				if (error) {
-					printf("ERROR %d 3rd GRBaddconstr(): %s\n", error, GRBgeterrormsg(*env));
-					return 0;
-				}
-
-			}
-		}
+		for(k = 1; k <= board_size; k++)
+			append_constraint(cbeg, cind, &num_constrs, &num_nz,
+					ilp_var(board_size, 0, j, k), board_size * board_size, board_size);
 
 	/*Constraint 4: each block has one of each possible value*/
 	for(a = 0; a < n; a++) /*block row*/
-		for(b = 0; b < m; b++){ /*block column*/
-			for(k = 0; k < board_size; k++){ /*checked value*/
-				current = 0;
+		for(b = 0; b < m; b++) /*block column*/
+			for(k = 1; k <= board_size; k++){ /*checked value*/
+				cbeg[num_constrs++] = num_nz;
 				for(i = a * m; i < (a+1) * m; i++) 			/*going through the block a,b*/
-					for(j = b * n; j < (b+1) * n ; j++){
-						if(var_indexs[i][j][k] > 0){
-							(*ind)[current] = var_indexs[i][j][k] - 1;
-							(*val)[current] = 1;
-							current += 1;
-						}
-					}
-					if(current > 0){
-						error = GRBaddconstr(*model, current, *ind, *val, GRB_EQUAL, 1.0, "c4");
-						if (error) {
-							printf("ERROR %d 4th GRBaddconstr(): %s\n", error, GRBgeterrormsg(*env));
-							return 0;
-						}
-					}
+					for(j = b * n; j < (b+1) * n ; j++)
+						cind[num_nz++] = ilp_var(board_size, i, j, k);
 			}
-		}
 
+	for(i = 0; i < num_nz; i++)
+		cval[i] = 1;
+	for(i = 0; i < num_constrs; i++){
+		sense[i] = GRB_EQUAL;
+		rhs[i] = 1.0;
+	}
+
+	error = GRBaddconstrs(*model, num_constrs, num_nz, cbeg, cind, cval, sense, rhs, NULL);
+	if (error)
+		printf("ERROR %d GRBaddconstrs(): %s\n", error, GRBgeterrormsg(*env));
+
+	free(cbeg);
+	free(cind);
+	free(cval);
+	free(sense);
+	free(rhs);
+	return error ? 0 : 1;
+}
+
+/*
+ * Makes sure the session has a model for the board's block geometry,
+ * building it (and dropping the former one) if needed.
+ * Returns 1 on success, 0 on failure.
+ */
+int build_model(Board* board){
+	int board_size = board->board_size;
+	int num_vars = board_size * board_size * board_size;
+	double* obj;
+	char* vtype;
+	int error;
+
+	if(ilp_session.model != NULL && ilp_session.block_rows == board->block_rows &&
+			ilp_session.block_cols == board->block_cols)
+		return 1;
+
+	free_ilp_model();
+	error = GRBnewmodel(ilp_session.env, &ilp_session.model, "integerLinearPrograming", 0, NULL, NULL, NULL, NULL, NULL);
+	if (error) {
+		printf("ERROR: %d GRBnewmodel(): %s\n", error, GRBgeterrormsg(ilp_session.env));
+		ilp_session.model = NULL;
+		return 0;
+	}
+
+	/*the model's buffers, kept until the model itself is freed*/
+	ilp_session.arena = create_arena(4 * arena_size_of(num_vars * sizeof(char)) +
+			arena_size_of(num_vars * sizeof(int)) + 2 * arena_size_of(num_vars * sizeof(double)));
+	ilp_session.lb = (char*) arena_alloc(ilp_session.arena, num_vars * sizeof(char));
+	ilp_session.ub = (char*) arena_alloc(ilp_session.arena, num_vars * sizeof(char));
+	ilp_session.wanted_lb = (char*) arena_alloc(ilp_session.arena, num_vars * sizeof(char));
+	ilp_session.wanted_ub = (char*) arena_alloc(ilp_session.arena, num_vars * sizeof(char));
+	ilp_session.ind = (int*) arena_alloc(ilp_session.arena, num_vars * sizeof(int));
+	ilp_session.val = (double*) arena_alloc(ilp_session.arena, num_vars * sizeof(double));
+	ilp_session.sol = (double*) arena_alloc(ilp_session.arena, num_vars * sizeof(double));
+	obj = (double*) malloc(num_vars * sizeof(double));
+	vtype = (char*) malloc(num_vars * sizeof(char));
+	if(!obj || !vtype){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	/*variables are created with Gurobi's default bounds for binaries, 0 and 1*/
+	memset(ilp_session.lb, 0, num_vars * sizeof(char));
+	memset(ilp_session.ub, 1, num_vars * sizeof(char));
 
+	error = add_variables(&ilp_session.env, &ilp_session.model, num_vars, &obj, &vtype) == 0 ||
+			add_constraints(&ilp_session.env, &ilp_session.model, board->block_rows, board->block_cols) == 0;
+	free(obj);
+	free(vtype);
+	if(error){
+		free_ilp_model();
+		return 0;
+	}
+
+	ilp_session.block_rows = board->block_rows;
+	ilp_session.block_cols = board->block_cols;
+	ilp_session.board_size = board_size;
+	ilp_session.num_vars = num_vars;
 	return 1;
 }
 
+/*
+ * Changes the given bound (lb or ub, with Gurobi's attribute name attr) of every variable
+ * whose wanted bound in wanted differs from the one in the model.
+ * Returns 1 on success, 0 on failure.
+ */
+int update_bounds(const char* attr, char* bounds, char* wanted){
+	int i;
+	int num_changed = 0;
+	int error;
+
+	for(i = 0; i < ilp_session.num_vars; i++)
+		if(bounds[i] != wanted[i]){
+			ilp_session.ind[num_changed] = i;
+			ilp_session.val[num_changed] = wanted[i];
+			num_changed++;
+		}
+	if(num_changed == 0)
+		return 1;
+
+	error = GRBsetdblattrlist(ilp_session.model, attr, num_changed, ilp_session.ind, ilp_session.val);
+	if (error) {
+		printf("ERROR %d GRBsetdblattrlist(): %s\n", error, GRBgeterrormsg(ilp_session.env));
+		return 0;
+	}
+	memcpy(bounds, wanted, ilp_session.num_vars * sizeof(char));
+	return 1;
+}
+
+/*
+ * Sets the bounds of the model's variables by the board's current state:
+ * a filled cell's variable of it's value is fixed to 1 and it's other ones to 0,
+ * and an empty cell's variables of values that are not candidates for it are fixed to 0.
+ * Only the bounds that changed since the last call are sent to Gurobi.
+ * Returns 1 on success, 0 on failure.
+ */
+int sync_bounds(Board* board){
+	int board_size = board->board_size;
+	int row, col, value, var;
+	char* lb = ilp_session.wanted_lb;
+	char* ub = ilp_session.wanted_ub;
+	ValueMask candidates;
+
+	for(row = 0; row < board_size; row++)
+		for(col = 0; col < board_size; col++){
+			var = ilp_var(board_size, row, col, 1);
+			value = get_cell_value(board, row, col);
+			if(value != 0){
+				memset(&lb[var], 0, board_size * sizeof(char));
+				memset(&ub[var], 0, board_size * sizeof(char));
+				lb[var + value - 1] = 1;
+				ub[var + value - 1] = 1;
+			}
+			else{
+				get_cell_candidates(board, row, col, &candidates);
+				memset(&lb[var], 0, board_size * sizeof(char));
+				for(value = 1; value <= board_size; value++)
+					ub[var + value - 1] = (char) mask_has(&candidates, value);
+			}
+		}
+
+	/*all the wanted bounds were computed above before any is sent. Gurobi keeps the changes
+	 * pending and applies them together at the next optimize, so the order of the two calls
+	 * doesn't matter*/
+	return update_bounds(GRB_DBL_ATTR_UB, ilp_session.ub, ub) &&
+			update_bounds(GRB_DBL_ATTR_LB, ilp_session.lb, lb);
+}
 
 /*
  * Function receives Gurobi's output of solution for the given board
- * and saves the solution on to the board itself.
+ * and saves the solution on to the board's empty cells.
  */
-void save_sol_to_board(Board* board, double* sol, int*** var_indexs){
+void save_sol_to_board(Board* board, double* sol){
 	int i, j, k;
-	int index;
-	for(i = 0; i < board->board_size; i++)
-		for(j = 0; j < board->board_size; j++){
-			for(k = 0; k < board->board_size; k++){
-				index = var_indexs[i][j][k];
-				if(index > 0 && sol[index-1] == 1.0){
-					/*printf("setting cell <%d,%d> to %d\n",j+1,i+1,k+1);*/
-					set_value_simple(board, i, j, k + 1);
+	int board_size = board->board_size;
+	for(i = 0; i < board_size; i++)
+		for(j = 0; j < board_size; j++){
+			if(get_cell_value(board, i, j) != 0)
+				continue;
+			for(k = 1; k <= board_size; k++){
+				if(sol[ilp_var(board_size, i, j, k)] > 0.5){
+					set_value_simple(board, i, j, k);
 					break;
 				}
 			}
@@ -259,123 +411,59 @@ void save_sol_to_board(Board* board, double* sol, int*** var_indexs){
  * When given save_solution as 1, the found solution (if exists) is saved on the given board.
  */
 int find_ILP_solution(Board* board, int save_solution){
-	GRBenv   *env   = NULL;
-	GRBmodel *model = NULL;
+	GRBenv   *env;
+	GRBmodel *model;
 	int error;
-	double*   sol;
-	int*      ind;
-	double*   val;
-	double*   obj;
-	char*     vtype;
 	int       optimstatus;
-	int var_amount = 0;
-	int index = 1;
-	int*** var_indexs;
-	int i,j,k;
-	Cell** game_board;
-	int board_size = board->board_size;
+	clock_t start;
 
-	/*autofill(&board);
+	ilp_build_seconds = 0;
+	ilp_solve_seconds = 0;
 
-	printf("autofilled succeffuly:\n");
-	printBoard(board);*/
-
-	game_board = board->current_board;
-
-	/* Create environment */
-	error = create_env(&env, &model);
-	if(error == 0 || env == NULL || model == NULL)
+	/* Get the environment and the model of the board's geometry, and fit it to the board */
+	if(create_env() == 0)
 		return 0;
-
-	/* Add variables */
-	var_indexs = allocate_var_indexs(board_size);
-	for(i = 0; i < board_size; i++){
-		for(j = 0; j < board_size; j++){
-			if(game_board[i][j].value == 0){
-				game_board[i][j].options = generate_options(board,i,j,0);
-				game_board[i][j].is_options_on = 1;
-				/*printf("num options for <%d,%d>: %d\n",j+1,i+1,game_board[i][j].options[0]);*/
-				if(game_board[i][j].options[0] == 0){
-					/*Cell with no valid value found, so there is no solution*/
-					destroy_var_indexs(var_indexs, board_size);
-					GRBfreemodel(model);
-					GRBfreeenv(env);
-					return 0;
-				}
-				for(k = 1; k <= game_board[i][j].options[0]; k++){
-					var_indexs[i][j][game_board[i][j].options[k] - 1] = index++;
-					/*printf("  Filled val_index %d,%d,%d with %d\n",j+1,i+1,(game_board[i][j].options[k] - 1), index - 1);*/
-				}
-				var_amount += game_board[i][j].options[0];
-			}
-		}
-	}
-
-
-	obj = (double*) malloc(var_amount * sizeof(double));
-	vtype = (char*) malloc(var_amount * sizeof(char));
-	ind = (int*) malloc(board_size * sizeof(int));
-	val = (double*) malloc(board_size * sizeof(double));
-	sol = (double*) malloc(var_amount * sizeof(double));
-
-	if( !obj || !vtype || !ind || !val || !sol){
-		printf(MALLOC_ERROR);
-		exit(0);
-	}
-
-	error = add_variables(&env, &model, var_amount, &obj, &vtype);
-	if(error == 0){
-		free_resorces(env, model, vtype, var_indexs, obj, ind, val, sol, board_size);
+	start = clock();
+	if(build_model(board) == 0)
 		return 0;
-	}
-
-	error = add_constraints(board, &env, &model, var_amount, &ind, &val, var_indexs);
-	if(error == 0){
-		free_resorces(env, model, vtype, var_indexs, obj, ind, val, sol, board_size);
+	env = ilp_session.env;
+	model = ilp_session.model;
+	if(sync_bounds(board) == 0){
+		/*the bounds Gurobi has are unknown, so the model is rebuilt next time*/
+		free_ilp_model();
 		return 0;
 	}
+	ilp_build_seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
 
 	/* Optimize model */
 	error = GRBoptimize(model);
 	if (error) {
 		printf("ERROR %d GRBoptimize(): %s\n", error, GRBgeterrormsg(env));
-		free_resorces(env, model, vtype, var_indexs, obj, ind, val, sol, board_size);
 		return 0;
 	}
 
-	/* Write model to 'mip1.lp' */
-	error = GRBwrite(model, "integerLinearPrograming.lp");
-	if (error) {
-		printf("ERROR %d GRBwrite(): %s\n", error, GRBgeterrormsg(env));
-		free_resorces(env, model, vtype, var_indexs, obj, ind, val, sol, board_size);
-		return 0;
-	}
+	/* Gurobi's own (wall clock) time of the optimization */
+	if(GRBgetdblattr(model, GRB_DBL_ATTR_RUNTIME, &ilp_solve_seconds))
+		ilp_solve_seconds = 0;
 
 	/* Get solution information */
 	error = GRBgetintattr(model, GRB_INT_ATTR_STATUS, &optimstatus);
 	if (error) {
 		printf("ERROR %d GRBgetintattr(): %s\n", error, GRBgeterrormsg(env));
-		free_resorces(env, model, vtype, var_indexs, obj, ind, val, sol, board_size);
 		return 0;
 	}
 
-	if(optimstatus == GRB_OPTIMAL){
-		if(save_solution == 1){
+	if(optimstatus != GRB_OPTIMAL) /*no solutions was found*/
+		return -1;
+
+	if(save_solution == 1){
 		/* get the solution - the assignment to each variable */
-			error = GRBgetdblattrarray(model, GRB_DBL_ATTR_X, 0, var_amount, sol);
-			if (error) {
-				printf("ERROR %d GRBgetdblattrarray(): %s\n", error, GRBgeterrormsg(env));
-				free_resorces(env, model, vtype, var_indexs, obj, ind, val, sol, board_size);
-				return 0;
-			  }
-			save_sol_to_board(board,sol,var_indexs);
+		error = GRBgetdblattrarray(model, GRB_DBL_ATTR_X, 0, ilp_session.num_vars, ilp_session.sol);
+		if (error) {
+			printf("ERROR %d GRBgetdblattrarray(): %s\n", error, GRBgeterrormsg(env));
+			return 0;
 		}
-		free_resorces(env, model, vtype, var_indexs, obj, ind, val, sol, board_size);
-		return 1;
-	}
-	else{ /*no solutions was found*/
-		free_resorces(env, model, vtype, var_indexs, obj, ind, val, sol, board_size);
-		return -1;
+		save_sol_to_board(board, ilp_session.sol);
 	}
+	return 1;
 }
-
@@ -1,11 +1,20 @@
 /*
  * The "gurobi_utils" module is in charge of all functions that directly use Gurobi
  * for finding ilp solutions.
+ * The Gurobi environment is loaded once, on the first ilp call, and is kept until
+ * free_ilp_session is called when the game exits.
+ * The model is kept as well, and is only rebuilt when the board's block geometry changes.
+ * Between calls, the board's state only changes the bounds of the model's variables.
  */
 
 #ifndef GUROBI_UTILS_H_
 #define GUROBI_UTILS_H_
 
+/* the cpu time (in seconds, by clock()) the last ilp call spent building/updating the model, and
+ * the wall clock time (in seconds, by Gurobi's RUNTIME) it spent solving it */
+extern double ilp_build_seconds;
+extern double ilp_solve_seconds;
+
 /*
  * Function uses ilp to try and find a solution to the given board.
  * If a solutions is found, returns 1. if everything ran through and no solution found, returns -1.
@@ -14,4 +23,9 @@
  */
 int find_ILP_solution(Board* board, int save_solution);
 
+/*
+ * Frees the Gurobi environment and model kept between ilp calls, if they exist.
+ */
+void free_ilp_session();
+
 #endif /* GUROBI_UTILS_H_ */
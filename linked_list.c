@@ -216,7 +216,7 @@ MovesList* copy_moves_list(MovesList* moves){
  * Returns a copy of the given TurnsList.
  */
 TurnsList* copy_turns_list(TurnsList* turns){
-	TurnsList* copy_list = initialize_turn_list();
+	TurnsList* copy_list;
 	TurnNode* turn_node;
 	MovesList* copy_moves;
 	int pos = 1;
@@ -10,11 +10,16 @@
 #include "SPBufferset.h"
 #include "main_aux.h"
 #include "board_utils.h"
+#include "mask_kernels.h"
 
 #define MAX_COMMAND_SIZE 256
 
 enum game_mode current_mode = INIT_MODE;
 int mark_errors = 1;
+int num_threads = 1;
+int use_propagation = 1;
+int use_symmetry = 1;
+backend_id solver_backend = BACKTRACK_BACKEND;
 
 
 
@@ -24,6 +29,7 @@ int main(){
 
 	srand(time(0));
 	SP_BUFF_SET();
+	select_mask_kernels();
 	opening_message();
 
 	while(1){
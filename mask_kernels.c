@@ -0,0 +1,153 @@
+/*
+ * The "mask_kernels" module contains the batch operations on ValueMask that dominate the work
+ * on large boards: computing the valid values of many cells at once from the masks of their
+ * row, column and block, and counting them.
+ * Every operation has a scalar implementation, and on x86-64 also SSE2 and AVX2 ones.
+ * The implementation is picked once at startup by the features of the running CPU.
+ */
+
+#include <stdio.h>
+
+#include "bitmask.h"
+#include "mask_kernels.h"
+
+/* the vector kernels handle a ValueMask as a single 128 bit register */
+#if defined(__GNUC__) && defined(__x86_64__) && MASK_WORD_BITS == 64 && MASK_WORDS == 2
+#define USE_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+
+/*
+ * The scalar implementation of candidates, for any CPU.
+ */
+void candidates_scalar(ValueMask* result, int* counts, ValueMask** a, ValueMask** b, ValueMask** c,
+		ValueMask* full, int num){
+	int i, w;
+	for(i = 0; i < num; i++){
+		for(w = 0; w < MASK_WORDS; w++)
+			result[i].words[w] = full->words[w] & ~(a[i]->words[w] | b[i]->words[w] | c[i]->words[w]);
+		if(counts != NULL)
+			counts[i] = mask_count(&result[i]);
+	}
+}
+
+MaskKernels scalar_kernels = {"scalar", candidates_scalar};
+
+
+#ifdef USE_X86_KERNELS
+
+/*
+ * Returns the amount of set bits in a 128 bit register, with SSE2 only.
+ */
+int popcount_sse2(__m128i x){
+	const __m128i m1 = _mm_set1_epi8(0x55);
+	const __m128i m2 = _mm_set1_epi8(0x33);
+	const __m128i m4 = _mm_set1_epi8(0x0f);
+	__m128i sums;
+
+	x = _mm_sub_epi64(x, _mm_and_si128(_mm_srli_epi64(x, 1), m1));
+	x = _mm_add_epi64(_mm_and_si128(x, m2), _mm_and_si128(_mm_srli_epi64(x, 2), m2));
+	x = _mm_and_si128(_mm_add_epi64(x, _mm_srli_epi64(x, 4)), m4);
+	/*summing the bytes of every 64 bit half*/
+	sums = _mm_sad_epu8(x, _mm_setzero_si128());
+	return _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums));
+}
+
+/*
+ * The SSE2 implementation of candidates: a cell at a time.
+ */
+void candidates_sse2(ValueMask* result, int* counts, ValueMask** a, ValueMask** b, ValueMask** c,
+		ValueMask* full, int num){
+	__m128i full_bits = _mm_loadu_si128((__m128i*) full->words);
+	__m128i used, valid;
+	int i;
+
+	for(i = 0; i < num; i++){
+		used = _mm_or_si128(_mm_loadu_si128((__m128i*) a[i]->words), _mm_loadu_si128((__m128i*) b[i]->words));
+		used = _mm_or_si128(used, _mm_loadu_si128((__m128i*) c[i]->words));
+		valid = _mm_andnot_si128(used, full_bits);
+		_mm_storeu_si128((__m128i*) result[i].words, valid);
+		if(counts != NULL)
+			counts[i] = popcount_sse2(valid);
+	}
+}
+
+MaskKernels sse2_kernels = {"sse2", candidates_sse2};
+
+/*
+ * Loads the masks of two cells into a single 256 bit register.
+ */
+__attribute__((target("avx2")))
+__m256i load_pair_avx2(ValueMask* low, ValueMask* high){
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((__m128i*) low->words)),
+			_mm_loadu_si128((__m128i*) high->words), 1);
+}
+
+/*
+ * The AVX2 implementation of candidates: two cells at a time,
+ * counting bits by a lookup of every nibble.
+ */
+__attribute__((target("avx2")))
+void candidates_avx2(ValueMask* result, int* counts, ValueMask** a, ValueMask** b, ValueMask** c,
+		ValueMask* full, int num){
+	const __m256i nibble_counts = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,
+			0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+	const __m256i low_nibbles = _mm256_set1_epi8(0x0f);
+	__m256i full_bits = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i*) full->words));
+	__m256i used, valid, sums;
+	int i;
+
+	for(i = 0; i + 1 < num; i += 2){
+		used = _mm256_or_si256(load_pair_avx2(a[i], a[i + 1]), load_pair_avx2(b[i], b[i + 1]));
+		used = _mm256_or_si256(used, load_pair_avx2(c[i], c[i + 1]));
+		valid = _mm256_andnot_si256(used, full_bits);
+		_mm_storeu_si128((__m128i*) result[i].words, _mm256_castsi256_si128(valid));
+		_mm_storeu_si128((__m128i*) result[i + 1].words, _mm256_extracti128_si256(valid, 1));
+		if(counts != NULL){
+			sums = _mm256_add_epi8(_mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(valid, low_nibbles)),
+					_mm256_shuffle_epi8(nibble_counts, _mm256_and_si256(_mm256_srli_epi16(valid, 4), low_nibbles)));
+			/*summing the bytes of every 64 bit quarter*/
+			sums = _mm256_sad_epu8(sums, _mm256_setzero_si256());
+			counts[i] = _mm256_extract_epi32(sums, 0) + _mm256_extract_epi32(sums, 2);
+			counts[i + 1] = _mm256_extract_epi32(sums, 4) + _mm256_extract_epi32(sums, 6);
+		}
+	}
+	if(i < num)
+		candidates_sse2(result + i, counts == NULL ? NULL : counts + i, a + i, b + i, c + i, full, num - i);
+}
+
+MaskKernels avx2_kernels = {"avx2", candidates_avx2};
+
+#endif /* USE_X86_KERNELS */
+
+
+MaskKernels* mask_kernels = &scalar_kernels;
+
+
+/*
+ * Picks the fastest implementation the running CPU supports.
+ * Should be called once at startup, before any counting threads are started.
+ */
+void select_mask_kernels(){
+#ifdef USE_X86_KERNELS
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+		mask_kernels = &avx2_kernels;
+	else
+		/*every x86-64 CPU has SSE2*/
+		mask_kernels = &sse2_kernels;
+#else
+	mask_kernels = &scalar_kernels;
+#endif
+}
+
+/*
+ * For every i < num, puts in result[i] the values of full that are in none of a[i], b[i] and c[i]
+ * (the valid values of a cell, given the masks of its row, column and block).
+ * If counts is not NULL, puts their amount in counts[i].
+ */
+void mask_candidates(ValueMask* result, int* counts, ValueMask** a, ValueMask** b, ValueMask** c,
+		ValueMask* full, int num){
+	mask_kernels->candidates(result, counts, a, b, c, full, num);
+}
@@ -0,0 +1,48 @@
+/*
+ * The "mask_kernels" module contains the batch operations on ValueMask that dominate the work
+ * on large boards: computing the valid values of many cells at once from the masks of their
+ * row, column and block, and counting them.
+ * Every operation has a scalar implementation, and on x86-64 also SSE2 and AVX2 ones.
+ * The implementation is picked once at startup by the features of the running CPU.
+ */
+
+#ifndef MASK_KERNELS_H_
+#define MASK_KERNELS_H_
+
+#include "bitmask.h"
+
+
+/*
+ * Structure: MaskKernels
+ * 		The implementations of the batch mask operations for a single instruction set.
+ *
+ * 		name: the name of the instruction set.
+ * 		candidates: for every i < num, puts in result[i] the values of full that are in none of
+ * 		            a[i], b[i] and c[i]. If counts is not NULL, puts their amount in counts[i].
+ */
+typedef struct mask_kernels_t{
+	const char* name;
+	void (*candidates)(ValueMask* result, int* counts, ValueMask** a, ValueMask** b, ValueMask** c,
+			ValueMask* full, int num);
+} MaskKernels;
+
+
+/* the implementation in use (scalar until select_mask_kernels is called) */
+extern MaskKernels* mask_kernels;
+
+
+/*
+ * Picks the fastest implementation the running CPU supports.
+ * Should be called once at startup, before any counting threads are started.
+ */
+void select_mask_kernels();
+
+/*
+ * For every i < num, puts in result[i] the values of full that are in none of a[i], b[i] and c[i]
+ * (the valid values of a cell, given the masks of its row, column and block).
+ * If counts is not NULL, puts their amount in counts[i].
+ */
+void mask_candidates(ValueMask* result, int* counts, ValueMask** a, ValueMask** b, ValueMask** c,
+		ValueMask* full, int num);
+
+#endif /* MASK_KERNELS_H_ */
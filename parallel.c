@@ -0,0 +1,331 @@
+/*
+ * The "parallel" module is in charge of counting the solutions of a board
+ * (num_solutions) with a number of threads.
+ * The search tree is split near its root into independent tasks. Every worker thread
+ * searches on its own scratch copy of the board with its own stack, and when a worker runs out
+ * of tasks it steals one from another worker. Busy workers hand out the untried values of
+ * their shallowest cell as new tasks when they see an idle worker.
+ * Exact counts are kept as BigNum, and use the relabelling symmetry of the values that are
+ * missing from the board to count only one solution of every group that differ by relabelling them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "board_utils.h"
+#include "solver.h"
+#include "stack.h"
+#include "bignum.h"
+#include "checkpoint.h"
+#include "parallel.h"
+
+/* amount of search steps between checks for idle workers */
+#define SPLIT_INTERVAL 1024
+
+
+/*
+ * Creates a task of the given cells, plus one more cell if row != -1.
+ */
+Task* create_task(int* moves, int num_moves, int row, int col, int value){
+	Task* task = (Task*) malloc(sizeof(Task));
+	if(task == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	task->num_moves = num_moves + (row != -1 ? 1 : 0);
+	task->moves = (int*) malloc((3 * task->num_moves + 1) * sizeof(int));
+	if(task->moves == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	if(num_moves > 0)
+		memcpy(task->moves, moves, 3 * num_moves * sizeof(int));
+	if(row != -1){
+		task->moves[3 * num_moves] = row;
+		task->moves[3 * num_moves + 1] = col;
+		task->moves[3 * num_moves + 2] = value;
+	}
+	task->next = NULL;
+	task->prev = NULL;
+	return task;
+}
+
+/*
+ * Destroys properly a given Task, freeing all allocated resources.
+ */
+void destroy_task(Task* task){
+	free(task->moves);
+	free(task);
+}
+
+/*
+ * Adds the task at the head of the deque. Caller must hold the shared lock.
+ */
+void deque_push_head(TaskDeque* deque, Task* task){
+	task->prev = NULL;
+	task->next = deque->head;
+	if(deque->head != NULL)
+		deque->head->prev = task;
+	else
+		deque->tail = task;
+	deque->head = task;
+}
+
+/*
+ * Removes and returns the task at the head (from_tail == 0) or tail (from_tail == 1)
+ * of the deque, or NULL if it is empty. Caller must hold the shared lock.
+ */
+Task* deque_take(TaskDeque* deque, int from_tail){
+	Task* task = from_tail ? deque->tail : deque->head;
+	if(task == NULL)
+		return NULL;
+	if(task->prev != NULL)
+		task->prev->next = task->next;
+	else
+		deque->head = task->next;
+	if(task->next != NULL)
+		task->next->prev = task->prev;
+	else
+		deque->tail = task->prev;
+	return task;
+}
+
+/*
+ * Returns the next task for the given worker: from its own deque if possible, otherwise
+ * stolen from another worker. Waits while other workers are still busy.
+ * Returns NULL once all workers are idle and no tasks are left.
+ */
+Task* get_task(Worker* worker){
+	SharedWork* shared = worker->shared;
+	Task* task = NULL;
+	int i;
+
+	pthread_mutex_lock(&shared->lock);
+	while(!shared->done){
+		task = deque_take(&shared->deques[worker->id], 0);
+		for(i = 1; task == NULL && i < shared->num_slots; i++)
+			task = deque_take(&shared->deques[(worker->id + i) % shared->num_slots], 1);
+		if(task != NULL)
+			break;
+
+		shared->num_idle++;
+		if(shared->num_idle == shared->num_workers){
+			/*no one is left to create new tasks*/
+			shared->done = 1;
+			pthread_cond_broadcast(&shared->work_available);
+			break;
+		}
+		pthread_cond_wait(&shared->work_available, &shared->lock);
+		if(!shared->done)
+			shared->num_idle--;
+	}
+	pthread_mutex_unlock(&shared->lock);
+	return task;
+}
+
+/*
+ * If other workers are idle and the worker has no waiting tasks, hands out the untried values
+ * of the search's shallowest cell that has any, as new tasks in the worker's deque.
+ * task is the task the search is running on.
+ */
+void split_search(Worker* worker, Search* search, Task* task){
+	SharedWork* shared = worker->shared;
+	StackElem* elem;
+	int* moves;
+	int depth, count = search->stack->count;
+	int i, value;
+
+	pthread_mutex_lock(&shared->lock);
+	if(shared->num_idle == 0 || shared->deques[worker->id].head != NULL){
+		pthread_mutex_unlock(&shared->lock);
+		return;
+	}
+
+	for(depth = 0; depth < count; depth++)
+		if(mask_count(&search->untried[depth]) > 0)
+			break;
+	if(depth == count){
+		pthread_mutex_unlock(&shared->lock);
+		return;
+	}
+
+	/*the moves leading to the split depth*/
+	moves = (int*) malloc((3 * (task->num_moves + depth) + 1) * sizeof(int));
+	if(moves == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	if(task->num_moves > 0)
+		memcpy(moves, task->moves, 3 * task->num_moves * sizeof(int));
+	for(i = 0; i < depth; i++){
+		elem = elem_at(search->stack, i);
+		moves[3 * (task->num_moves + i)] = elem->row;
+		moves[3 * (task->num_moves + i) + 1] = elem->col;
+		moves[3 * (task->num_moves + i) + 2] = elem->value;
+	}
+
+	elem = elem_at(search->stack, depth);
+	value = 0;
+	while((value = mask_next(&search->untried[depth], value)) != 0)
+		deque_push_head(&shared->deques[worker->id],
+				create_task(moves, task->num_moves + depth, elem->row, elem->col, value));
+	mask_clear(&search->untried[depth]);
+
+	pthread_cond_broadcast(&shared->work_available);
+	pthread_mutex_unlock(&shared->lock);
+	free(moves);
+}
+
+/*
+ * The function every worker thread runs: takes tasks until none are left,
+ * and counts the solutions of each on the worker's ScratchBoard.
+ */
+void* run_worker(void* arg){
+	Worker* worker = (Worker*) arg;
+	Search* search = create_search(worker->board, worker->shared->relabel);
+	Task* task;
+	int i;
+	long steps = 0;
+
+	while((task = get_task(worker)) != NULL){
+		for(i = 0; i < task->num_moves; i++)
+			index_place(search->index, search->scratch, task->moves[3*i], task->moves[3*i + 1], task->moves[3*i + 2]);
+
+		while(search_step(search) == 0){
+			if(++steps % SPLIT_INTERVAL == 0)
+				split_search(worker, search, task);
+		}
+
+		for(i = task->num_moves - 1; i >= 0; i--)
+			index_clear(search->index, search->scratch, task->moves[3*i], task->moves[3*i + 1]);
+		destroy_task(task);
+	}
+
+	worker->num_sol = search->num_sol;
+	worker->nodes = search->nodes;
+	destroy_search(search);
+	return NULL;
+}
+
+/*
+ * Function recieves a board, and counts the solutions of the board's current state
+ * with num_threads threads, as count_search (so with relabel == 1 the amount of solutions
+ * is the returned amount times (amount of values missing from the board)!).
+ */
+unsigned long parallel_count(Board* b, int num_threads, int relabel){
+	SharedWork shared;
+	Worker* workers;
+	pthread_t* threads;
+	int* started;
+	int i;
+	unsigned long num_sol = 0;
+
+	if(num_threads <= 1 || check_board_errors(b) == 1)
+		return count_search(b, relabel);
+
+	workers = (Worker*) malloc(num_threads * sizeof(Worker));
+	threads = (pthread_t*) malloc(num_threads * sizeof(pthread_t));
+	started = (int*) calloc(num_threads, sizeof(int));
+	shared.deques = (TaskDeque*) calloc(num_threads, sizeof(TaskDeque));
+	if(!workers || !threads || !started || !shared.deques){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	pthread_mutex_init(&shared.lock, NULL);
+	pthread_cond_init(&shared.work_available, NULL);
+	shared.num_slots = num_threads;
+	shared.num_workers = num_threads;
+	shared.num_idle = 0;
+	shared.done = 0;
+	shared.relabel = relabel;
+
+	/*the whole search tree is the first task*/
+	deque_push_head(&shared.deques[0], create_task(NULL, 0, -1, 0, 0));
+
+	for(i = 0; i < num_threads; i++){
+		workers[i].id = i;
+		workers[i].board = b;
+		workers[i].num_sol = 0;
+		workers[i].nodes = 0;
+		workers[i].shared = &shared;
+	}
+	for(i = 0; i < num_threads; i++){
+		if(pthread_create(&threads[i], NULL, run_worker, &workers[i]) == 0){
+			started[i] = 1;
+			continue;
+		}
+		/*the other workers steal whatever is left in this worker's deque*/
+		printf("Error: failed to start counting thread %d, counting with less threads.\n", i + 1);
+		pthread_mutex_lock(&shared.lock);
+		shared.num_workers--;
+		if(shared.num_workers > 0 && shared.num_idle == shared.num_workers){
+			shared.done = 1;
+			pthread_cond_broadcast(&shared.work_available);
+		}
+		pthread_mutex_unlock(&shared.lock);
+	}
+	if(shared.num_workers == 0){
+		destroy_task(deque_take(&shared.deques[0], 0));
+		num_sol = count_search(b, relabel);
+	}
+	else
+		last_search_nodes = 0;
+
+	for(i = 0; i < num_threads; i++){
+		if(started[i]){
+			pthread_join(threads[i], NULL);
+			num_sol += workers[i].num_sol;
+			last_search_nodes += workers[i].nodes;
+		}
+	}
+
+	pthread_mutex_destroy(&shared.lock);
+	pthread_cond_destroy(&shared.work_available);
+	free(shared.deques);
+	free(started);
+	free(threads);
+	free(workers);
+	return num_sol;
+}
+
+/*
+ * Function recieves a board, and puts in result the exact number of possible solutions for
+ * the board's current state, counted by num_threads threads.
+ * If use_symmetry is on, only one solution of every relabelling of the values missing from
+ * the board is searched, and the count is multiplied by (amount of missing values)!.
+ * A count with a single thread writes checkpoints (see the "checkpoint" module).
+ * Returns 1 if the count finished, 0 if the user stopped it (result then has the partial count).
+ */
+int exact_num_solutions(Board* b, int num_threads, BigNum* result){
+	unsigned long num_sol;
+	int finished = 1;
+
+	if(num_threads <= 1)
+		finished = count_with_checkpoints(b, use_symmetry, &num_sol);
+	else
+		num_sol = parallel_count(b, num_threads, use_symmetry);
+	bignum_set(result, num_sol);
+	if(use_symmetry)
+		multiply_by_relabellings(b, result);
+	return finished;
+}
+
+/*
+ * Multiplies result by (amount of values missing from the board)!, the amount of
+ * relabellings of the missing values.
+ */
+void multiply_by_relabellings(Board* b, BigNum* result){
+	ValueMask present;
+	int row, col;
+	int num_missing;
+
+	mask_clear(&present);
+	for(row = 0; row < b->board_size; row++)
+		for(col = 0; col < b->board_size; col++)
+			if(get_cell_value(b, row, col) != 0)
+				mask_add(&present, get_cell_value(b, row, col));
+	for(num_missing = b->board_size - mask_count(&present); num_missing > 1; num_missing--)
+		bignum_mul(result, num_missing);
+}
@@ -0,0 +1,117 @@
+/*
+ * The "parallel" module is in charge of counting the solutions of a board
+ * (num_solutions) with a number of threads.
+ * The search tree is split near its root into independent tasks. Every worker thread
+ * searches on its own scratch copy of the board with its own stack, and when a worker runs out
+ * of tasks it steals one from another worker. Busy workers hand out the untried values of
+ * their shallowest cell as new tasks when they see an idle worker.
+ * Exact counts are kept as BigNum, and use the relabelling symmetry of the values that are
+ * missing from the board to count only one solution of every group that differ by relabelling them.
+ */
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <pthread.h>
+
+#include "board_utils.h"
+#include "bignum.h"
+
+#define MAX_THREADS 64
+
+
+/*
+ * Structure: Task
+ * 		Used to represent a subtree of the search: the cells that are filled at its root.
+ *
+ * 		num_moves: the amount of cells filled.
+ * 		moves: the filled cells as (row, col, value) triples, in the order they are filled.
+ * 		next: the task after this one in its deque (towards the tail).
+ * 		prev: the task before this one in its deque (towards the head).
+ */
+typedef struct task_t{
+	int num_moves;
+	int* moves;
+	struct task_t* next;
+	struct task_t* prev;
+} Task;
+
+
+/*
+ * Structure: TaskDeque
+ * 		The tasks waiting for a single worker.
+ * 		The worker takes tasks from the head, other workers steal from the tail
+ * 		(the oldest tasks, which are the closest to the root).
+ */
+typedef struct task_deque_t{
+	Task* head;
+	Task* tail;
+} TaskDeque;
+
+
+/*
+ * Structure: SharedWork
+ * 		The state that all workers of a single count share. Guarded by lock.
+ *
+ * 		deques: a TaskDeque for each worker.
+ * 		num_slots: the amount of deques.
+ * 		num_workers: the amount of running workers.
+ * 		num_idle: the amount of workers waiting for a task.
+ * 		done: 1 once all workers are idle with no tasks left, 0 until then.
+ * 		relabel: 1 if the workers' searches count with relabelling (see create_search), 0 otherwise.
+ */
+typedef struct shared_work_t{
+	pthread_mutex_t lock;
+	pthread_cond_t work_available;
+	TaskDeque* deques;
+	int num_slots;
+	int num_workers;
+	int num_idle;
+	int done;
+	int relabel;
+} SharedWork;
+
+
+/*
+ * Structure: Worker
+ * 		A single counting thread.
+ *
+ * 		id: the index of the worker's deque in shared.
+ * 		board: the counted board. Workers only read it, when creating their Search.
+ * 		num_sol: the amount of solutions the worker found.
+ * 		nodes: the amount of cells the worker's search filled by choice.
+ * 		shared: the state shared with the other workers.
+ */
+typedef struct worker_t{
+	int id;
+	Board* board;
+	unsigned long num_sol;
+	long nodes;
+	SharedWork* shared;
+} Worker;
+
+
+/*
+ * Function recieves a board, and counts the solutions of the board's current state
+ * with num_threads threads, as count_search (so with relabel == 1 the amount of solutions
+ * is the returned amount times (amount of values missing from the board)!).
+ */
+unsigned long parallel_count(Board* b, int num_threads, int relabel);
+
+/*
+ * Function recieves a board, and puts in result the exact number of possible solutions for
+ * the board's current state, counted by num_threads threads.
+ * If use_symmetry is on, only one solution of every relabelling of the values missing from
+ * the board is searched, and the count is multiplied by (amount of missing values)!.
+ * A count with a single thread writes checkpoints (see the "checkpoint" module).
+ * Returns 1 if the count finished, 0 if the user stopped it (result then has the partial count).
+ */
+int exact_num_solutions(Board* b, int num_threads, BigNum* result);
+
+/*
+ * Multiplies result by (amount of values missing from the board)!, the amount of
+ * relabellings of the missing values.
+ */
+void multiply_by_relabellings(Board* b, BigNum* result);
+
+#endif /* PARALLEL_H_ */
@@ -40,7 +40,7 @@ int get_fixed_cells(Board* board) {
 const char* get_command_name(int cmd_id) {
 	static char* names[] = { "invalid_command","solve", "edit", "mark_errors",
 			"print_board", "set", "validate", "generate", "undo", "redo", "save",
-			"hint","num_solutions", "autofill", "reset", "exit" };
+			"hint","num_solutions", "autofill", "autofill_all", "reset", "num_solutions_upto", "threads", "propagation", "symmetry", "resume", "backend", "exit" };
 	if (cmd_id < INVALID_COMMAND || cmd_id > EXIT) {
 		return 0;
 	} else {
@@ -50,7 +50,7 @@ const char* get_command_name(int cmd_id) {
 
 enum command_id get_command_id(char *type) {
 	enum command_id cmd_id;
-	if (!type || type == '\0')
+	if (!type || *type == '\0')
 		return INVALID_COMMAND;
 	for (cmd_id = INVALID_COMMAND; cmd_id <= EXIT; cmd_id++) {
 		if (!strcmp(type, get_command_name(cmd_id)))
@@ -107,6 +107,12 @@ int get_num_params(enum command_id cmd_id){
 		case EDIT:
 		case MARK_ERRORS:
 		case SAVE:
+		case NUM_SOLUTIONS_UPTO:
+		case THREADS:
+		case PROPAGATION:
+		case SYMMETRY:
+		case RESUME:
+		case BACKEND:
 			return 1;
 			break;
 		case GENERATE:
@@ -142,6 +148,7 @@ int check_command_availability(enum command_id cmd_id){
 		/* always available: */
 		case SOLVE:
 		case EDIT:
+		case RESUME:
 		case EXIT:
 			return 1;
 			break;
@@ -154,6 +161,11 @@ int check_command_availability(enum command_id cmd_id){
 		case SAVE:
 		case NUM_SOLUTIONS:
 		case RESET:
+		case NUM_SOLUTIONS_UPTO:
+		case THREADS:
+		case PROPAGATION:
+		case SYMMETRY:
+		case BACKEND:
 			if(current_mode == INIT_MODE){
 				printf("Error: The command is unavailable in the current game mode.\n");
 				printf("%s is available only in SOLVE and EDIT modes.\n",get_command_name(cmd_id));
@@ -166,6 +178,7 @@ int check_command_availability(enum command_id cmd_id){
 		case MARK_ERRORS:
 		case HINT:
 		case AUTOFILL:
+		case AUTOFILL_ALL:
 			if(current_mode == SOLVE_MODE)
 				return 1;
 			else{
@@ -235,7 +248,7 @@ Command* parse_command(char* userInput) {
 			return NULL;
 		}
 
-		if(cmd_id == EDIT || cmd_id == SOLVE || cmd_id == SAVE)
+		if(cmd_id == EDIT || cmd_id == SOLVE || cmd_id == SAVE || cmd_id == RESUME)
 			/*strcpy(path_param,token);*/
 			path_param = token;
 		else{
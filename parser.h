@@ -11,7 +11,7 @@
 enum command_id {
 	INVALID_COMMAND, SOLVE, EDIT, MARK_ERRORS, PRINT_BOARD,
 	SET, VALIDATE, GENERATE, UNDO, REDO, SAVE, HINT,
-	NUM_SOLUTIONS, AUTOFILL, RESET, EXIT
+	NUM_SOLUTIONS, AUTOFILL, AUTOFILL_ALL, RESET, NUM_SOLUTIONS_UPTO, THREADS, PROPAGATION, SYMMETRY, RESUME, BACKEND, EXIT
 };
 
 /*
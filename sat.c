@@ -0,0 +1,904 @@
+/*
+ * The "sat" module solves boards as boolean satisfiability problems, with a CDCL
+ * (conflict driven clause learning) solver.
+ * A board is encoded with a variable for every value in every cell: every cell has exactly
+ * one value, every row, column and block has every value exactly once, and every filled cell
+ * has it's value. On boards bigger than 9x9, "at most one" is encoded with a sequential counter
+ * (extra variables) instead of a clause for every pair, which would be about 2 * N^4 clauses.
+ * The solver keeps two watched literals in every clause, learns a clause from every conflict
+ * (by the first unique implication point), jumps back to the level it makes a new deduction in,
+ * and branches on the variables most active in recent conflicts (kept in a heap by activity,
+ * so a decision doesn't scan all the variables). It restarts by the Luby
+ * sequence, and drops the less active half of it's learned clauses once there are too many.
+ * The encoding of a block geometry is built once and kept, and boards are solved under
+ * assumptions of their filled cells, so clauses learned for one board help with the next ones.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "game.h"
+#include "solver.h"
+#include "sat.h"
+
+
+/* the factor activities are decayed by after every conflict */
+#define ACTIVITY_DECAY 0.95
+/* activities are scaled down once one passes this, to keep them in range */
+#define ACTIVITY_LIMIT 1e100
+/* the factor clause activities are decayed by after every conflict */
+#define CLAUSE_DECAY 0.999
+/* the amount of conflicts a unit of the Luby sequence stands for, between restarts */
+#define RESTART_UNIT 100
+/* the least amount of learned clauses kept before dropping any */
+#define MIN_LEARNTS 2000
+/* the factor max_learnts grows by every time learned clauses are dropped */
+#define LEARNTS_GROWTH 1.1
+/* the largest board size whose "at most one" constraints are encoded by pairs (see sat_add_exactly_one) */
+#define SAT_PAIRWISE_LIMIT 9
+
+
+/* the solver of the last geometry solved, with the encoding of it's empty board */
+SatSolver* cached_solver = NULL;
+int cached_block_rows = 0;
+int cached_block_cols = 0;
+
+
+/*
+ * Function allocates memory of the given size, exiting if it fails.
+ */
+void* sat_alloc(size_t size){
+	void* memory = malloc(size);
+	if(memory == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	return memory;
+}
+
+/*
+ * Function reallocates memory to the given size, exiting if it fails.
+ */
+void* sat_realloc(void* memory, size_t size){
+	memory = realloc(memory, size);
+	if(memory == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	return memory;
+}
+
+/*
+ * Creates a solver with the given amount of variables and no clauses.
+ * Only the first num_decision_vars variables are branched on, the rest must be implied by them.
+ */
+SatSolver* create_sat_solver(int num_vars, int num_decision_vars){
+	SatSolver* solver = (SatSolver*) sat_alloc(sizeof(SatSolver));
+	int i;
+
+	solver->num_vars = num_vars;
+	solver->num_decision_vars = num_decision_vars;
+	solver->num_clauses = 0;
+	solver->clauses_capacity = 64;
+	solver->clause_start = (int*) sat_alloc(solver->clauses_capacity * sizeof(int));
+	solver->clause_size = (int*) sat_alloc(solver->clauses_capacity * sizeof(int));
+	solver->clause_learnt = (char*) sat_alloc(solver->clauses_capacity * sizeof(char));
+	solver->clause_activity = (double*) sat_alloc(solver->clauses_capacity * sizeof(double));
+	solver->clause_inc = 1;
+	solver->num_learnts = 0;
+	solver->max_learnts = 0;
+	solver->num_lits = 0;
+	solver->lits_capacity = 256;
+	solver->lits = (int*) sat_alloc(solver->lits_capacity * sizeof(int));
+
+	solver->watches = (WatchList*) sat_alloc(2 * num_vars * sizeof(WatchList));
+	for(i = 0; i < 2 * num_vars; i++){
+		solver->watches[i].count = 0;
+		solver->watches[i].capacity = 0;
+		solver->watches[i].clauses = NULL;
+	}
+
+	solver->value = (signed char*) sat_alloc(num_vars * sizeof(signed char));
+	solver->level = (int*) sat_alloc(num_vars * sizeof(int));
+	solver->reason = (int*) sat_alloc(num_vars * sizeof(int));
+	solver->phase = (signed char*) sat_alloc(num_vars * sizeof(signed char));
+	solver->activity = (double*) sat_alloc(num_vars * sizeof(double));
+	solver->heap = (int*) sat_alloc(num_vars * sizeof(int));
+	solver->heap_index = (int*) sat_alloc(num_vars * sizeof(int));
+	solver->trail = (int*) sat_alloc(num_vars * sizeof(int));
+	solver->trail_lim = (int*) sat_alloc((num_vars + 1) * sizeof(int));
+	solver->seen = (char*) sat_alloc(num_vars * sizeof(char));
+	solver->learnt = (int*) sat_alloc((num_vars + 1) * sizeof(int));
+	for(i = 0; i < num_vars; i++){
+		solver->value[i] = 0;
+		solver->level[i] = 0;
+		solver->reason[i] = -1;
+		solver->phase[i] = 1;
+		solver->activity[i] = 0;
+		solver->seen[i] = 0;
+		/*all activities are equal, so any order is a heap*/
+		solver->heap[i] = i;
+		solver->heap_index[i] = (i < num_decision_vars) ? i : -1;
+	}
+	solver->heap_size = num_decision_vars;
+	solver->activity_inc = 1;
+	solver->trail_size = 0;
+	solver->decision_level = 0;
+	solver->queue_head = 0;
+	solver->unsat = 0;
+	solver->conflicts = 0;
+	solver->restarts = 0;
+	return solver;
+}
+
+/*
+ * Destroys properly a given SatSolver, freeing all allocated resources.
+ */
+void destroy_sat_solver(SatSolver* solver){
+	int i;
+	if(solver == NULL)
+		return;
+	for(i = 0; i < 2 * solver->num_vars; i++)
+		free(solver->watches[i].clauses);
+	free(solver->watches);
+	free(solver->clause_start);
+	free(solver->clause_size);
+	free(solver->clause_learnt);
+	free(solver->clause_activity);
+	free(solver->lits);
+	free(solver->value);
+	free(solver->level);
+	free(solver->reason);
+	free(solver->phase);
+	free(solver->activity);
+	free(solver->heap);
+	free(solver->heap_index);
+	free(solver->trail);
+	free(solver->trail_lim);
+	free(solver->seen);
+	free(solver->learnt);
+	free(solver);
+}
+
+/*
+ * Returns 1 if the literal is true, -1 if it is false and 0 if it's variable is unassigned.
+ */
+int sat_lit_value(SatSolver* solver, int lit){
+	int value = solver->value[lit >> 1];
+	return (lit & 1) ? -value : value;
+}
+
+/*
+ * Adds the clause to the list of clauses watching the literal.
+ */
+void sat_add_watch(SatSolver* solver, int lit, int clause){
+	WatchList* list = &solver->watches[lit];
+	if(list->count == list->capacity){
+		list->capacity = (list->capacity == 0) ? 4 : 2 * list->capacity;
+		list->clauses = (int*) sat_realloc(list->clauses, list->capacity * sizeof(int));
+	}
+	list->clauses[list->count++] = clause;
+}
+
+/*
+ * Keeps a clause of num (at least 2) literals, watched by it's two first literals.
+ * learnt is 1 if the clause was learned from a conflict.
+ * Returns the index of the new clause.
+ */
+int sat_store_clause(SatSolver* solver, int* lits, int num, int learnt){
+	int i;
+	int clause = solver->num_clauses;
+
+	if(solver->num_clauses == solver->clauses_capacity){
+		solver->clauses_capacity *= 2;
+		solver->clause_start = (int*) sat_realloc(solver->clause_start, solver->clauses_capacity * sizeof(int));
+		solver->clause_size = (int*) sat_realloc(solver->clause_size, solver->clauses_capacity * sizeof(int));
+		solver->clause_learnt = (char*) sat_realloc(solver->clause_learnt, solver->clauses_capacity * sizeof(char));
+		solver->clause_activity = (double*) sat_realloc(solver->clause_activity,
+				solver->clauses_capacity * sizeof(double));
+	}
+	while(solver->num_lits + num > solver->lits_capacity){
+		solver->lits_capacity *= 2;
+		solver->lits = (int*) sat_realloc(solver->lits, solver->lits_capacity * sizeof(int));
+	}
+
+	solver->clause_start[clause] = solver->num_lits;
+	solver->clause_size[clause] = num;
+	solver->clause_learnt[clause] = (char) learnt;
+	solver->clause_activity[clause] = 0;
+	solver->num_learnts += learnt;
+	for(i = 0; i < num; i++)
+		solver->lits[solver->num_lits++] = lits[i];
+	solver->num_clauses++;
+
+	sat_add_watch(solver, lits[0], clause);
+	sat_add_watch(solver, lits[1], clause);
+	return clause;
+}
+
+/*
+ * Makes the literal true at the current decision level, with the given reason clause
+ * (-1 for a decision or a unit clause).
+ */
+void sat_enqueue(SatSolver* solver, int lit, int reason){
+	int var = lit >> 1;
+	solver->value[var] = (lit & 1) ? -1 : 1;
+	solver->level[var] = solver->decision_level;
+	solver->reason[var] = reason;
+	solver->trail[solver->trail_size++] = lit;
+}
+
+/*
+ * Adds a clause of num literals to the solver. May only be called at decision level 0
+ * (before solving, or after sat_backtrack(solver, 0)).
+ * Literals that are already false are dropped, and a clause that is already true is ignored.
+ * The given literals array may be changed.
+ */
+void sat_add_clause(SatSolver* solver, int* lits, int num){
+	int i, j = 0;
+
+	if(solver->unsat)
+		return;
+	for(i = 0; i < num; i++){
+		switch(sat_lit_value(solver, lits[i])){
+			case 1:
+				return;
+			case 0:
+				lits[j++] = lits[i];
+				break;
+			default:
+				break;
+		}
+	}
+
+	if(j == 0)
+		solver->unsat = 1;
+	else if(j == 1)
+		sat_enqueue(solver, lits[0], -1);
+	else
+		sat_store_clause(solver, lits, j, 0);
+}
+
+/*
+ * Moves the variable at position i of the heap up, until it's parent is at least as active.
+ */
+void sat_heap_up(SatSolver* solver, int i){
+	int var = solver->heap[i];
+	int parent;
+
+	while(i > 0){
+		parent = (i - 1) / 2;
+		if(solver->activity[solver->heap[parent]] >= solver->activity[var])
+			break;
+		solver->heap[i] = solver->heap[parent];
+		solver->heap_index[solver->heap[i]] = i;
+		i = parent;
+	}
+	solver->heap[i] = var;
+	solver->heap_index[var] = i;
+}
+
+/*
+ * Moves the variable at position i of the heap down, until it is at least as active as it's children.
+ */
+void sat_heap_down(SatSolver* solver, int i){
+	int var = solver->heap[i];
+	int child;
+
+	while(2 * i + 1 < solver->heap_size){
+		child = 2 * i + 1;
+		if(child + 1 < solver->heap_size &&
+				solver->activity[solver->heap[child + 1]] > solver->activity[solver->heap[child]])
+			child++;
+		if(solver->activity[solver->heap[child]] <= solver->activity[var])
+			break;
+		solver->heap[i] = solver->heap[child];
+		solver->heap_index[solver->heap[i]] = i;
+		i = child;
+	}
+	solver->heap[i] = var;
+	solver->heap_index[var] = i;
+}
+
+/*
+ * Adds the variable to the heap, if it is a decision variable that isn't in it.
+ */
+void sat_heap_insert(SatSolver* solver, int var){
+	if(var >= solver->num_decision_vars || solver->heap_index[var] != -1)
+		return;
+	solver->heap[solver->heap_size] = var;
+	solver->heap_index[var] = solver->heap_size;
+	sat_heap_up(solver, solver->heap_size++);
+}
+
+/*
+ * Removes the most active variable from the heap and returns it. The heap must not be empty.
+ */
+int sat_heap_pop(SatSolver* solver){
+	int var = solver->heap[0];
+
+	solver->heap_index[var] = -1;
+	solver->heap_size--;
+	if(solver->heap_size > 0){
+		solver->heap[0] = solver->heap[solver->heap_size];
+		solver->heap_index[solver->heap[0]] = 0;
+		sat_heap_down(solver, 0);
+	}
+	return var;
+}
+
+/*
+ * Undoes all assignments made above the given decision level.
+ * The variables become unassigned again, so they are put back in the heap.
+ */
+void sat_backtrack(SatSolver* solver, int level){
+	int i, var;
+
+	if(solver->decision_level <= level)
+		return;
+	for(i = solver->trail_size - 1; i >= solver->trail_lim[level]; i--){
+		var = solver->trail[i] >> 1;
+		solver->phase[var] = solver->value[var];
+		solver->value[var] = 0;
+		solver->reason[var] = -1;
+		sat_heap_insert(solver, var);
+	}
+	solver->trail_size = solver->trail_lim[level];
+	solver->queue_head = solver->trail_size;
+	solver->decision_level = level;
+}
+
+/*
+ * Makes all literals implied by the assignments not propagated yet true.
+ * Returns the index of a clause whose literals all became false, or -1 if there is none.
+ */
+int sat_propagate(SatSolver* solver){
+	WatchList* list;
+	int false_lit, clause, i, j, k, tmp;
+	int* lits;
+	int size;
+
+	while(solver->queue_head < solver->trail_size){
+		false_lit = solver->trail[solver->queue_head++] ^ 1;
+		list = &solver->watches[false_lit];
+
+		for(i = 0, j = 0; i < list->count; i++){
+			clause = list->clauses[i];
+			lits = &solver->lits[solver->clause_start[clause]];
+			size = solver->clause_size[clause];
+
+			/*making the false literal the second watch*/
+			if(lits[0] == false_lit){
+				lits[0] = lits[1];
+				lits[1] = false_lit;
+			}
+			if(sat_lit_value(solver, lits[0]) == 1){
+				list->clauses[j++] = clause;
+				continue;
+			}
+
+			/*looking for a new literal to watch*/
+			for(k = 2; k < size; k++)
+				if(sat_lit_value(solver, lits[k]) != -1)
+					break;
+			if(k < size){
+				tmp = lits[1];
+				lits[1] = lits[k];
+				lits[k] = tmp;
+				sat_add_watch(solver, lits[1], clause);
+				continue;
+			}
+
+			/*the clause is unit or conflicting*/
+			list->clauses[j++] = clause;
+			if(sat_lit_value(solver, lits[0]) == -1){
+				for(i++; i < list->count; i++)
+					list->clauses[j++] = list->clauses[i];
+				list->count = j;
+				return clause;
+			}
+			sat_enqueue(solver, lits[0], clause);
+		}
+		list->count = j;
+	}
+	return -1;
+}
+
+/*
+ * Raises the activity of the variable, after it took part in a conflict, and moves it up the heap.
+ * Scaling all activities down keeps their order, so the heap stays as it is.
+ */
+void sat_bump_activity(SatSolver* solver, int var){
+	int i;
+	solver->activity[var] += solver->activity_inc;
+	if(solver->activity[var] > ACTIVITY_LIMIT){
+		for(i = 0; i < solver->num_vars; i++)
+			solver->activity[i] /= ACTIVITY_LIMIT;
+		solver->activity_inc /= ACTIVITY_LIMIT;
+	}
+	if(solver->heap_index[var] != -1)
+		sat_heap_up(solver, solver->heap_index[var]);
+}
+
+/*
+ * Raises the activity of the clause if it is a learned one, after it took part in a conflict.
+ */
+void sat_bump_clause(SatSolver* solver, int clause){
+	int i;
+	if(!solver->clause_learnt[clause])
+		return;
+	solver->clause_activity[clause] += solver->clause_inc;
+	if(solver->clause_activity[clause] > ACTIVITY_LIMIT){
+		for(i = 0; i < solver->num_clauses; i++)
+			solver->clause_activity[i] /= ACTIVITY_LIMIT;
+		solver->clause_inc /= ACTIVITY_LIMIT;
+	}
+}
+
+/*
+ * Analyses the conflict of the given clause, and puts in solver->learnt a clause implied by it
+ * that has a single literal of the current decision level (the first unique implication point),
+ * as it's first literal. The literal of the highest level of the rest is put second.
+ * Puts the amount of literals in *learnt_size, and returns the level to jump back to.
+ */
+int sat_analyze(SatSolver* solver, int conflict, int* learnt_size){
+	int counter = 0;
+	int lit = -1;
+	int index = solver->trail_size - 1;
+	int size = 1;
+	int i, var, first, max_i, tmp;
+	int* lits;
+
+	do{
+		sat_bump_clause(solver, conflict);
+		lits = &solver->lits[solver->clause_start[conflict]];
+		/*the first literal of a reason clause is the literal it implied*/
+		first = (lit == -1) ? 0 : 1;
+		for(i = first; i < solver->clause_size[conflict]; i++){
+			var = lits[i] >> 1;
+			if(!solver->seen[var] && solver->level[var] > 0){
+				solver->seen[var] = 1;
+				sat_bump_activity(solver, var);
+				if(solver->level[var] == solver->decision_level)
+					counter++;
+				else
+					solver->learnt[size++] = lits[i];
+			}
+		}
+		/*the next marked literal of the current level, going back on the trail*/
+		while(!solver->seen[solver->trail[index] >> 1])
+			index--;
+		lit = solver->trail[index--];
+		conflict = solver->reason[lit >> 1];
+		solver->seen[lit >> 1] = 0;
+		counter--;
+	} while(counter > 0);
+	solver->learnt[0] = lit ^ 1;
+
+	for(i = 1; i < size; i++)
+		solver->seen[solver->learnt[i] >> 1] = 0;
+	*learnt_size = size;
+	if(size == 1)
+		return 0;
+
+	max_i = 1;
+	for(i = 2; i < size; i++)
+		if(solver->level[solver->learnt[i] >> 1] > solver->level[solver->learnt[max_i] >> 1])
+			max_i = i;
+	tmp = solver->learnt[1];
+	solver->learnt[1] = solver->learnt[max_i];
+	solver->learnt[max_i] = tmp;
+	return solver->level[solver->learnt[1] >> 1];
+}
+
+/*
+ * Returns the literal to branch on: the unassigned decision variable with the highest activity,
+ * with the value it was last assigned. Returns -1 if all decision variables are assigned.
+ * Assigned variables met at the top of the heap are dropped from it (backtracking puts them back).
+ */
+int sat_pick_branch(SatSolver* solver){
+	int var;
+	while(solver->heap_size > 0){
+		var = sat_heap_pop(solver);
+		if(solver->value[var] == 0)
+			return 2 * var + (solver->phase[var] == -1 ? 1 : 0);
+	}
+	return -1;
+}
+
+/*
+ * Compares two doubles, for qsort.
+ */
+int compare_doubles(const void* a, const void* b){
+	double x = *(const double*) a;
+	double y = *(const double*) b;
+	return (x > y) - (x < y);
+}
+
+/*
+ * Drops the learned clauses (of more than 2 literals) whose activity is below the median one.
+ * May only be called at decision level 0, where no clause is the reason of an assignment
+ * that a conflict could be analysed through.
+ */
+void sat_reduce_learnts(SatSolver* solver){
+	double* activities;
+	double threshold;
+	int num = 0;
+	int i, j, k, start;
+	int num_lits = 0;
+
+	activities = (double*) sat_alloc((solver->num_learnts + 1) * sizeof(double));
+	for(i = 0; i < solver->num_clauses; i++)
+		if(solver->clause_learnt[i] && solver->clause_size[i] > 2)
+			activities[num++] = solver->clause_activity[i];
+	if(num == 0){
+		free(activities);
+		return;
+	}
+	qsort(activities, num, sizeof(double), compare_doubles);
+	threshold = activities[num / 2];
+	free(activities);
+
+	/*moving the kept clauses to the front*/
+	for(i = 0, j = 0; i < solver->num_clauses; i++){
+		if(solver->clause_learnt[i] && solver->clause_size[i] > 2 && solver->clause_activity[i] < threshold){
+			solver->num_learnts--;
+			continue;
+		}
+		start = solver->clause_start[i];
+		for(k = 0; k < solver->clause_size[i]; k++)
+			solver->lits[num_lits + k] = solver->lits[start + k];
+		solver->clause_start[j] = num_lits;
+		solver->clause_size[j] = solver->clause_size[i];
+		solver->clause_learnt[j] = solver->clause_learnt[i];
+		solver->clause_activity[j] = solver->clause_activity[i];
+		num_lits += solver->clause_size[i];
+		j++;
+	}
+	solver->num_clauses = j;
+	solver->num_lits = num_lits;
+
+	/*clause indexes changed, so the watches and reasons are rebuilt*/
+	for(i = 0; i < 2 * solver->num_vars; i++)
+		solver->watches[i].count = 0;
+	for(i = 0; i < solver->num_clauses; i++){
+		sat_add_watch(solver, solver->lits[solver->clause_start[i]], i);
+		sat_add_watch(solver, solver->lits[solver->clause_start[i] + 1], i);
+	}
+	for(i = 0; i < solver->trail_size; i++)
+		solver->reason[solver->trail[i] >> 1] = -1;
+}
+
+/*
+ * Returns the i-th element (from 0) of the Luby sequence 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ...
+ */
+int luby(int i){
+	int size = 1, seq = 0;
+	while(size < i + 1){
+		seq++;
+		size = 2 * size + 1;
+	}
+	while(size - 1 != i){
+		size = (size - 1) >> 1;
+		seq--;
+		i = i % size;
+	}
+	return 1 << seq;
+}
+
+/*
+ * Searches for an assignment that satisfies all clauses, and makes the given num literals true.
+ * Returns 1 if one was found (it is left in solver->value until the next call), and -1 if there
+ * is none. Clauses learned on the way are implied by the clauses alone, so they are kept.
+ * Every assumption is made as the decision of it's own level (an empty level if it is already
+ * true), before any other decision.
+ */
+int sat_solve_assuming(SatSolver* solver, int* assumptions, int num){
+	int conflict, level, size, lit;
+	long restart_conflicts = 0;
+
+	sat_backtrack(solver, 0);
+	if(solver->unsat)
+		return -1;
+	if(solver->max_learnts < MIN_LEARNTS)
+		solver->max_learnts = (solver->num_vars / 3 > MIN_LEARNTS) ? solver->num_vars / 3 : MIN_LEARNTS;
+
+	while(1){
+		conflict = sat_propagate(solver);
+		if(conflict >= 0){
+			solver->conflicts++;
+			restart_conflicts++;
+			if(solver->decision_level == 0){
+				solver->unsat = 1;
+				return -1;
+			}
+			level = sat_analyze(solver, conflict, &size);
+			sat_backtrack(solver, level);
+			if(size == 1)
+				sat_enqueue(solver, solver->learnt[0], -1);
+			else{
+				conflict = sat_store_clause(solver, solver->learnt, size, 1);
+				sat_bump_clause(solver, conflict);
+				sat_enqueue(solver, solver->learnt[0], conflict);
+			}
+			solver->activity_inc /= ACTIVITY_DECAY;
+			solver->clause_inc /= CLAUSE_DECAY;
+			continue;
+		}
+
+		if(restart_conflicts >= (long) luby(solver->restarts) * RESTART_UNIT){
+			sat_backtrack(solver, 0);
+			solver->restarts++;
+			restart_conflicts = 0;
+			if(solver->num_learnts >= solver->max_learnts){
+				sat_reduce_learnts(solver);
+				solver->max_learnts *= LEARNTS_GROWTH;
+			}
+			continue;
+		}
+
+		if(solver->decision_level < num){
+			/*the next assumption*/
+			lit = assumptions[solver->decision_level];
+			if(sat_lit_value(solver, lit) == -1)
+				return -1;
+			solver->trail_lim[solver->decision_level++] = solver->trail_size;
+			if(sat_lit_value(solver, lit) == 0)
+				sat_enqueue(solver, lit, -1);
+			continue;
+		}
+
+		lit = sat_pick_branch(solver);
+		if(lit == -1)
+			return 1;
+		solver->trail_lim[solver->decision_level++] = solver->trail_size;
+		sat_enqueue(solver, lit, -1);
+	}
+}
+
+/*
+ * Searches for an assignment that satisfies all clauses.
+ * Returns 1 if one was found (it is left in solver->value), and -1 if there is none.
+ */
+int sat_solve(SatSolver* solver){
+	return sat_solve_assuming(solver, NULL, 0);
+}
+
+/*
+ * Returns the variable of "value in cell <row,col>" in the board's encoding.
+ */
+int sat_var(int board_size, int row, int col, int value){
+	return (row * board_size + col) * board_size + (value - 1);
+}
+
+/*
+ * Returns the amount of extra variables the encoding of a board of the given size needs,
+ * after it's board_size^3 cell variables (see sat_add_exactly_one).
+ */
+int sat_num_counter_vars(int board_size){
+	if(board_size <= SAT_PAIRWISE_LIMIT)
+		return 0;
+	/*num - 1 for each of the 4 * board_size^2 constraints*/
+	return 4 * board_size * board_size * (board_size - 1);
+}
+
+/*
+ * Adds clauses saying exactly one of the given num variables is true.
+ * Up to SAT_PAIRWISE_LIMIT variables, "at most one" is a clause for every pair of them.
+ * Above it, the num^2 / 2 pairs are too many, so it is a sequential counter: num - 1 new variables,
+ * from *next_var on, where the i-th says one of the first i + 1 given variables is true, and 3 * num - 4
+ * clauses (a given variable makes it's counter true, a counter makes the next one true, and a
+ * given variable must be false if the counter before it is true).
+ * Unit propagation deduces as much from the counter as from the pairs.
+ * lits is a buffer of at least num literals.
+ */
+void sat_add_exactly_one(SatSolver* solver, int* vars, int num, int* lits, int* next_var){
+	int i, j;
+	int pair[2];
+	int counter = *next_var;
+
+	for(i = 0; i < num; i++)
+		lits[i] = 2 * vars[i];
+	sat_add_clause(solver, lits, num);
+
+	if(num <= SAT_PAIRWISE_LIMIT){
+		for(i = 0; i < num; i++)
+			for(j = i + 1; j < num; j++){
+				pair[0] = 2 * vars[i] + 1;
+				pair[1] = 2 * vars[j] + 1;
+				sat_add_clause(solver, pair, 2);
+			}
+		return;
+	}
+
+	*next_var += num - 1;
+	for(i = 0; i < num; i++){
+		if(i < num - 1){
+			/*vars[i] -> counter i*/
+			pair[0] = 2 * vars[i] + 1;
+			pair[1] = 2 * (counter + i);
+			sat_add_clause(solver, pair, 2);
+		}
+		if(i > 0){
+			/*counter i-1 -> not vars[i]*/
+			pair[0] = 2 * (counter + i - 1) + 1;
+			pair[1] = 2 * vars[i] + 1;
+			sat_add_clause(solver, pair, 2);
+			if(i < num - 1){
+				/*counter i-1 -> counter i*/
+				pair[0] = 2 * (counter + i - 1) + 1;
+				pair[1] = 2 * (counter + i);
+				sat_add_clause(solver, pair, 2);
+			}
+		}
+	}
+}
+
+/*
+ * Creates a solver with the encoding of an empty board of the given block geometry
+ * (the filled cells of a board are given as assumptions, or as unit clauses).
+ */
+SatSolver* sat_encode_geometry(int block_rows, int block_cols){
+	int board_size = block_rows * block_cols;
+	int next_var = board_size * board_size * board_size;
+	/*the counters are implied by the cells, so only the cells are branched on*/
+	SatSolver* solver = create_sat_solver(next_var + sat_num_counter_vars(board_size), next_var);
+	int* vars = (int*) sat_alloc(board_size * sizeof(int));
+	int* lits = (int*) sat_alloc(board_size * sizeof(int));
+	int row, col, value, i, block, start_row, start_col;
+
+	/*every cell has exactly one value*/
+	for(row = 0; row < board_size; row++)
+		for(col = 0; col < board_size; col++){
+			for(i = 0; i < board_size; i++)
+				vars[i] = sat_var(board_size, row, col, i + 1);
+			sat_add_exactly_one(solver, vars, board_size, lits, &next_var);
+		}
+
+	/*every row, column and block has every value exactly once*/
+	for(value = 1; value <= board_size; value++){
+		for(row = 0; row < board_size; row++){
+			for(i = 0; i < board_size; i++)
+				vars[i] = sat_var(board_size, row, i, value);
+			sat_add_exactly_one(solver, vars, board_size, lits, &next_var);
+		}
+		for(col = 0; col < board_size; col++){
+			for(i = 0; i < board_size; i++)
+				vars[i] = sat_var(board_size, i, col, value);
+			sat_add_exactly_one(solver, vars, board_size, lits, &next_var);
+		}
+		for(block = 0; block < board_size; block++){
+			start_row = (block / block_rows) * block_rows;
+			start_col = (block % block_rows) * block_cols;
+			for(i = 0; i < board_size; i++)
+				vars[i] = sat_var(board_size, start_row + i / block_cols, start_col + i % block_cols, value);
+			sat_add_exactly_one(solver, vars, board_size, lits, &next_var);
+		}
+	}
+
+	free(vars);
+	free(lits);
+	return solver;
+}
+
+/*
+ * Puts in lits the literals saying every filled cell of the board has it's value.
+ * Returns their amount.
+ */
+int sat_filled_cells(Board* board, int* lits){
+	int row, col, value;
+	int board_size = board->board_size;
+	int num = 0;
+
+	for(row = 0; row < board_size; row++)
+		for(col = 0; col < board_size; col++){
+			value = get_cell_value(board, row, col);
+			if(value != 0)
+				lits[num++] = 2 * sat_var(board_size, row, col, value);
+		}
+	return num;
+}
+
+/*
+ * Returns the value the solver's current assignment gives the cell <row,col>.
+ */
+int sat_assigned_cell_value(SatSolver* solver, int board_size, int row, int col){
+	int value;
+	for(value = 1; value <= board_size; value++)
+		if(solver->value[sat_var(board_size, row, col, value)] == 1)
+			return value;
+	return 0;
+}
+
+/*
+ * Uses the SAT solver to try and find a solution to the given board.
+ * The solver of the board's geometry is kept between calls (with the clauses it learned),
+ * and the board's filled cells are given to it as assumptions.
+ * If a solution is found, returns 1. If there is no solution, returns -1.
+ * When given save_solution as 1, the found solution (if exists) is saved on the given board.
+ */
+int sat_find_solution(Board* board, int save_solution){
+	int* assumptions;
+	int num_assumptions;
+	int row, col;
+	int board_size = board->board_size;
+	int result;
+
+	if(check_board_errors(board) == 1)
+		return -1;
+
+	if(cached_solver == NULL || cached_block_rows != board->block_rows ||
+			cached_block_cols != board->block_cols){
+		sat_free_cache();
+		cached_solver = sat_encode_geometry(board->block_rows, board->block_cols);
+		cached_block_rows = board->block_rows;
+		cached_block_cols = board->block_cols;
+	}
+
+	assumptions = (int*) sat_alloc(board_size * board_size * sizeof(int));
+	num_assumptions = sat_filled_cells(board, assumptions);
+	result = sat_solve_assuming(cached_solver, assumptions, num_assumptions);
+	free(assumptions);
+
+	if(result == 1 && save_solution)
+		for(row = 0; row < board_size; row++)
+			for(col = 0; col < board_size; col++)
+				if(get_cell_value(board, row, col) == 0)
+					set_value_simple(board, row, col, sat_assigned_cell_value(cached_solver, board_size, row, col));
+	return result;
+}
+
+/*
+ * Returns the number of solutions of the given board, found with the SAT solver
+ * (every solution found is excluded by a new clause, until there are none).
+ * Stops once limit solutions were found (limit <= 0 means no limit).
+ * The clauses excluding solutions only hold for this board, so it uses a solver of it's own,
+ * with the filled cells as unit clauses.
+ */
+int sat_count_upto(Board* board, int limit){
+	SatSolver* solver;
+	int* lits;
+	int num_lits, i;
+	int row, col, value;
+	int board_size = board->board_size;
+	int num_sol = 0;
+
+	if(check_board_errors(board) == 1)
+		return 0;
+
+	solver = sat_encode_geometry(board->block_rows, board->block_cols);
+	lits = (int*) sat_alloc(board_size * board_size * sizeof(int));
+	num_lits = sat_filled_cells(board, lits);
+	for(i = 0; i < num_lits; i++)
+		sat_add_clause(solver, &lits[i], 1);
+
+	while(sat_solve(solver) == 1){
+		num_sol++;
+		if(limit > 0 && num_sol >= limit)
+			break;
+
+		/*excluding the solution: one of the empty cells has to have a diffrent value*/
+		num_lits = 0;
+		for(row = 0; row < board_size; row++)
+			for(col = 0; col < board_size; col++)
+				if(get_cell_value(board, row, col) == 0){
+					value = sat_assigned_cell_value(solver, board_size, row, col);
+					lits[num_lits++] = 2 * sat_var(board_size, row, col, value) + 1;
+				}
+		sat_backtrack(solver, 0);
+		sat_add_clause(solver, lits, num_lits);
+	}
+	free(lits);
+	destroy_sat_solver(solver);
+	return num_sol;
+}
+
+/*
+ * Frees the solver kept for the last geometry solved, if there is one.
+ */
+void sat_free_cache(){
+	if(cached_solver != NULL){
+		destroy_sat_solver(cached_solver);
+		cached_solver = NULL;
+	}
+}
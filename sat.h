@@ -0,0 +1,174 @@
+/*
+ * The "sat" module solves boards as boolean satisfiability problems, with a CDCL
+ * (conflict driven clause learning) solver.
+ * A board is encoded with a variable for every value in every cell: every cell has exactly
+ * one value, every row, column and block has every value exactly once, and every filled cell
+ * has it's value. On boards bigger than 9x9, "at most one" is encoded with a sequential counter
+ * (extra variables) instead of a clause for every pair, which would be about 2 * N^4 clauses.
+ * The solver keeps two watched literals in every clause, learns a clause from every conflict
+ * (by the first unique implication point), jumps back to the level it makes a new deduction in,
+ * and branches on the variables most active in recent conflicts (kept in a heap by activity,
+ * so a decision doesn't scan all the variables). It restarts by the Luby
+ * sequence, and drops the less active half of it's learned clauses once there are too many.
+ * The encoding of a block geometry is built once and kept, and boards are solved under
+ * assumptions of their filled cells, so clauses learned for one board help with the next ones.
+ */
+
+#ifndef SAT_H_
+#define SAT_H_
+
+#include "board_utils.h"
+
+
+/*
+ * Structure: WatchList
+ * 		A growing array of the clauses that watch a single literal.
+ *
+ * 		count: the amount of clauses in the list.
+ * 		capacity: the amount of clauses the list has room for.
+ * 		clauses: the indexes of the clauses.
+ */
+typedef struct watch_list_t{
+	int count;
+	int capacity;
+	int* clauses;
+} WatchList;
+
+/*
+ * Structure: SatSolver
+ * 		A CDCL solver. Variables are numbered from 0, and the literals of variable v are
+ * 		2v (v is true) and 2v + 1 (v is false).
+ * 		Clauses (given and learned) are kept one after the other in lits, and are identified by
+ * 		their index. The two first literals of a clause are the ones it is watched by, and the
+ * 		first literal of a clause that is the reason of an assignment is the assigned literal.
+ *
+ * 		num_vars: the amount of variables.
+ * 		num_decision_vars: the amount of variables (from 0) that are branched on. Once they are all
+ * 		                   assigned, propagation must have assigned the rest.
+ * 		num_clauses, clauses_capacity: the amount of clauses, and the amount there's room for.
+ * 		clause_start, clause_size: the position of every clause's literals in lits, and their amount.
+ * 		clause_learnt: for every clause, 1 if it was learned from a conflict, 0 if it was given.
+ * 		clause_activity: for every clause, how much it took part in recent conflicts (used for learned ones).
+ * 		clause_inc: the amount a clause's activity is bumped by.
+ * 		num_learnts: the amount of learned clauses kept.
+ * 		max_learnts: the amount of learned clauses above which the less active half is dropped.
+ * 		num_lits, lits_capacity: the amount of literals in lits, and the amount there's room for.
+ * 		lits: the literals of all clauses.
+ * 		watches: for every literal, the clauses watching it.
+ * 		value: for every variable, 1 if it is true, -1 if it is false and 0 if it is unassigned.
+ * 		level: for every assigned variable, the decision level it was assigned in.
+ * 		reason: for every assigned variable, the clause that implied it (-1 for decisions).
+ * 		phase: for every variable, the value it was last assigned (used for branching on it again).
+ * 		activity: for every variable, how much it took part in recent conflicts.
+ * 		activity_inc: the amount a variable's activity is bumped by.
+ * 		heap: a binary max-heap of decision variables by activity, that has every unassigned one
+ * 		      (and may still have assigned ones, which are skipped when branching).
+ * 		      heap_size is their amount.
+ * 		heap_index: for every variable, it's position in heap, or -1 if it isn't in it.
+ * 		trail: the assigned literals, in order of assignment. trail_size is their amount.
+ * 		trail_lim: for every decision level, the trail size before it's decision.
+ * 		decision_level: the current decision level.
+ * 		queue_head: the position in trail of the next assignment to propagate.
+ * 		seen: marks for variables, used while analysing a conflict.
+ * 		learnt: a buffer for the clause learned from a conflict.
+ * 		unsat: 1 once the clauses are known to be unsatisfiable.
+ * 		conflicts: the amount of conflicts met so far.
+ * 		restarts: the amount of restarts made so far.
+ */
+typedef struct sat_solver_t{
+	int num_vars;
+	int num_decision_vars;
+	int num_clauses;
+	int clauses_capacity;
+	int* clause_start;
+	int* clause_size;
+	char* clause_learnt;
+	double* clause_activity;
+	double clause_inc;
+	int num_learnts;
+	double max_learnts;
+	int num_lits;
+	int lits_capacity;
+	int* lits;
+	WatchList* watches;
+	signed char* value;
+	int* level;
+	int* reason;
+	signed char* phase;
+	double* activity;
+	double activity_inc;
+	int* heap;
+	int heap_size;
+	int* heap_index;
+	int* trail;
+	int trail_size;
+	int* trail_lim;
+	int decision_level;
+	int queue_head;
+	char* seen;
+	int* learnt;
+	int unsat;
+	long conflicts;
+	long restarts;
+} SatSolver;
+
+
+/*
+ * Creates a solver with the given amount of variables and no clauses.
+ * Only the first num_decision_vars variables are branched on, the rest must be implied by them.
+ */
+SatSolver* create_sat_solver(int num_vars, int num_decision_vars);
+
+/*
+ * Destroys properly a given SatSolver, freeing all allocated resources.
+ */
+void destroy_sat_solver(SatSolver* solver);
+
+/*
+ * Adds a clause of num literals to the solver. May only be called at decision level 0
+ * (before solving, or after sat_backtrack(solver, 0)).
+ * Literals that are already false are dropped, and a clause that is already true is ignored.
+ */
+void sat_add_clause(SatSolver* solver, int* lits, int num);
+
+/*
+ * Undoes all assignments made above the given decision level.
+ */
+void sat_backtrack(SatSolver* solver, int level);
+
+/*
+ * Searches for an assignment that satisfies all clauses, and makes the given num literals true.
+ * Returns 1 if one was found (it is left in solver->value until the next call), and -1 if there
+ * is none. Clauses learned on the way are implied by the clauses alone, so they are kept.
+ */
+int sat_solve_assuming(SatSolver* solver, int* assumptions, int num);
+
+/*
+ * Searches for an assignment that satisfies all clauses.
+ * Returns 1 if one was found (it is left in solver->value), and -1 if there is none.
+ */
+int sat_solve(SatSolver* solver);
+
+/*
+ * Uses the SAT solver to try and find a solution to the given board.
+ * The solver of the board's geometry is kept between calls (with the clauses it learned),
+ * and the board's filled cells are given to it as assumptions.
+ * If a solution is found, returns 1. If there is no solution, returns -1.
+ * When given save_solution as 1, the found solution (if exists) is saved on the given board.
+ */
+int sat_find_solution(Board* board, int save_solution);
+
+/*
+ * Returns the number of solutions of the given board, found with the SAT solver
+ * (every solution found is excluded by a new clause, until there are none).
+ * Stops once limit solutions were found (limit <= 0 means no limit).
+ * The clauses excluding solutions only hold for this board, so it uses a solver of it's own.
+ */
+int sat_count_upto(Board* board, int limit);
+
+/*
+ * Frees the solver kept for the last geometry solved, if there is one.
+ */
+void sat_free_cache();
+
+#endif /* SAT_H_ */
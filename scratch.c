@@ -0,0 +1,189 @@
+/*
+ * The "scratch" module contains the ScratchBoard struct and relevant use functions.
+ * A ScratchBoard is the compact private state the Exhaustive Backtracking search (num_solutions)
+ * fills and clears cells on: only the cell values and the values used in every row, column and
+ * block, without fixed cells, error marking or moves history.
+ * It is read from a Board once, and never writes back to it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "board_utils.h"
+#include "bitmask.h"
+#include "mask_kernels.h"
+#include "scratch.h"
+
+
+/*
+ * Creates a ScratchBoard with the values of the given board's current state.
+ * The board must not have erroneous cells.
+ */
+ScratchBoard* create_scratch_board(Board* b){
+	ScratchBoard* s;
+	int row, col, value;
+	int units[3];
+	int i;
+
+	if((s = (ScratchBoard*) malloc(sizeof(ScratchBoard))) == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	s->block_rows = b->block_rows;
+	s->block_cols = b->block_cols;
+	s->board_size = b->board_size;
+	s->values = (int*) malloc(b->board_size * b->board_size * sizeof(int));
+	s->units_used = (ValueMask*) malloc(3 * b->board_size * sizeof(ValueMask));
+	s->value_count = (int*) calloc(b->board_size + 1, sizeof(int));
+	if(s->values == NULL || s->units_used == NULL || s->value_count == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	for(i = 0; i < 3 * b->board_size; i++)
+		mask_clear(&s->units_used[i]);
+
+	s->num_empty = 0;
+	for(row = 0; row < b->board_size; row++)
+		for(col = 0; col < b->board_size; col++){
+			value = get_cell_value(b, row, col);
+			s->values[row * b->board_size + col] = value;
+			if(value == 0){
+				s->num_empty++;
+				continue;
+			}
+			s->value_count[value]++;
+			scratch_cell_units(s, row, col, units);
+			for(i = 0; i < 3; i++)
+				mask_add(&s->units_used[units[i]], value);
+		}
+	return s;
+}
+
+/*
+ * Destroys properly a given ScratchBoard, freeing all allocated resources.
+ */
+void destroy_scratch_board(ScratchBoard* s){
+	free(s->values);
+	free(s->units_used);
+	free(s->value_count);
+	free(s);
+}
+
+/*
+ * Returns the index of the block that the cell at row, col is in (as get_block_index).
+ */
+int scratch_block_index(ScratchBoard* s, int row, int col){
+	return (row / s->block_rows) * s->block_rows + (col / s->block_cols);
+}
+
+/*
+ * Units are the rows, columns and blocks of the board, numbered 0 to 3*board_size - 1:
+ * rows are 0 to board_size - 1, then columns, then blocks (by scratch_block_index).
+ * Puts in row, col the position of the k-th cell (0 to board_size - 1) of the given unit.
+ */
+void scratch_unit_cell(ScratchBoard* s, int unit, int k, int* row, int* col){
+	int board_size = s->board_size;
+	if(unit < board_size){
+		*row = unit;
+		*col = k;
+	}
+	else if(unit < 2 * board_size){
+		*row = k;
+		*col = unit - board_size;
+	}
+	else{
+		unit -= 2 * board_size;
+		*row = (unit / s->block_rows) * s->block_rows + k / s->block_cols;
+		*col = (unit % s->block_rows) * s->block_cols + k % s->block_cols;
+	}
+}
+
+/*
+ * Puts in units the row, column and block units of the cell at row, col.
+ */
+void scratch_cell_units(ScratchBoard* s, int row, int col, int* units){
+	units[0] = row;
+	units[1] = s->board_size + col;
+	units[2] = 2 * s->board_size + scratch_block_index(s, row, col);
+}
+
+/*
+ * Puts in candidates the values that can be entered to the cell at row, col
+ * without clashing with a value in it's row, column or block.
+ */
+void scratch_candidates(ScratchBoard* s, int row, int col, ValueMask* candidates){
+	ValueMask full, used;
+	int units[3];
+
+	/*a single cell is cheaper without the call through the mask kernels*/
+	scratch_cell_units(s, row, col, units);
+	mask_fill(&full, s->board_size);
+	mask_union3(&used, &s->units_used[units[0]], &s->units_used[units[1]], &s->units_used[units[2]]);
+	mask_and_not(candidates, &full, &used);
+}
+
+/*
+ * Puts in candidates[col] the candidates (as scratch_candidates) of every cell in the given row,
+ * in a single pass of the mask kernels. If counts is not NULL, puts their amounts in counts[col].
+ */
+void scratch_row_candidates(ScratchBoard* s, int row, ValueMask* candidates, int* counts){
+	ValueMask full;
+	ValueMask* rows[MAX_MASK_VALUES];
+	ValueMask* cols[MAX_MASK_VALUES];
+	ValueMask* blocks[MAX_MASK_VALUES];
+	int units[3];
+	int col;
+
+	for(col = 0; col < s->board_size; col++){
+		scratch_cell_units(s, row, col, units);
+		rows[col] = &s->units_used[units[0]];
+		cols[col] = &s->units_used[units[1]];
+		blocks[col] = &s->units_used[units[2]];
+	}
+	mask_fill(&full, s->board_size);
+	mask_candidates(candidates, counts, rows, cols, blocks, &full, s->board_size);
+}
+
+/*
+ * Returns 1 if value is in none of the units of the cell at row, col, 0 otherwise.
+ */
+int scratch_is_candidate(ScratchBoard* s, int row, int col, int value){
+	int units[3];
+	scratch_cell_units(s, row, col, units);
+	return !mask_has(&s->units_used[units[0]], value) && !mask_has(&s->units_used[units[1]], value) &&
+			!mask_has(&s->units_used[units[2]], value);
+}
+
+/*
+ * Enters value (which must be one of it's candidates) to the empty cell at row, col.
+ */
+void scratch_place(ScratchBoard* s, int row, int col, int value){
+	int units[3];
+	int i;
+
+	scratch_cell_units(s, row, col, units);
+	for(i = 0; i < 3; i++)
+		mask_add(&s->units_used[units[i]], value);
+	s->values[row * s->board_size + col] = value;
+	s->value_count[value]++;
+	s->num_empty--;
+}
+
+/*
+ * Empties the cell at row, col.
+ */
+void scratch_clear(ScratchBoard* s, int row, int col){
+	int value = s->values[row * s->board_size + col];
+	int units[3];
+	int i;
+
+	if(value == 0)
+		return;
+	/*the search never has clashing values, so the value is the only one of its kind in the units*/
+	scratch_cell_units(s, row, col, units);
+	for(i = 0; i < 3; i++)
+		mask_remove(&s->units_used[units[i]], value);
+	s->values[row * s->board_size + col] = 0;
+	s->value_count[value]--;
+	s->num_empty++;
+}
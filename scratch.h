@@ -0,0 +1,93 @@
+/*
+ * The "scratch" module contains the ScratchBoard struct and relevant use functions.
+ * A ScratchBoard is the compact private state the Exhaustive Backtracking search (num_solutions)
+ * fills and clears cells on: only the cell values and the values used in every row, column and
+ * block, without fixed cells, error marking or moves history.
+ * It is read from a Board once, and never writes back to it.
+ */
+
+#ifndef SCRATCH_H_
+#define SCRATCH_H_
+
+#include "board_utils.h"
+#include "bitmask.h"
+
+
+/*
+ * Structure: ScratchBoard
+ * 		Used to represent the cells of a board while it is searched.
+ * 		Cells are identified by row * board_size + col.
+ *
+ * 		block_rows, block_cols, board_size: the geometry of the board it was read from.
+ * 		values: the value of each cell (0 if empty).
+ * 		units_used: for each unit (see scratch_unit_cell), the values currently in it.
+ * 		value_count: for each value (1 to board_size), the amount of cells that have it.
+ * 		num_empty: the amount of empty cells.
+ */
+typedef struct scratch_board_t{
+	int block_rows;
+	int block_cols;
+	int board_size;
+	int* values;
+	ValueMask* units_used;
+	int* value_count;
+	int num_empty;
+} ScratchBoard;
+
+
+/*
+ * Creates a ScratchBoard with the values of the given board's current state.
+ * The board must not have erroneous cells.
+ */
+ScratchBoard* create_scratch_board(Board* b);
+
+/*
+ * Destroys properly a given ScratchBoard, freeing all allocated resources.
+ */
+void destroy_scratch_board(ScratchBoard* s);
+
+/*
+ * Returns the index of the block that the cell at row, col is in (as get_block_index).
+ */
+int scratch_block_index(ScratchBoard* s, int row, int col);
+
+/*
+ * Units are the rows, columns and blocks of the board, numbered 0 to 3*board_size - 1:
+ * rows are 0 to board_size - 1, then columns, then blocks (by scratch_block_index).
+ * Puts in row, col the position of the k-th cell (0 to board_size - 1) of the given unit.
+ */
+void scratch_unit_cell(ScratchBoard* s, int unit, int k, int* row, int* col);
+
+/*
+ * Puts in units the row, column and block units of the cell at row, col.
+ */
+void scratch_cell_units(ScratchBoard* s, int row, int col, int* units);
+
+/*
+ * Puts in candidates the values that can be entered to the cell at row, col
+ * without clashing with a value in it's row, column or block.
+ */
+void scratch_candidates(ScratchBoard* s, int row, int col, ValueMask* candidates);
+
+/*
+ * Puts in candidates[col] the candidates (as scratch_candidates) of every cell in the given row,
+ * in a single pass of the mask kernels. If counts is not NULL, puts their amounts in counts[col].
+ */
+void scratch_row_candidates(ScratchBoard* s, int row, ValueMask* candidates, int* counts);
+
+/*
+ * Returns 1 if value is in none of the units of the cell at row, col, 0 otherwise.
+ */
+int scratch_is_candidate(ScratchBoard* s, int row, int col, int value);
+
+/*
+ * Enters value (which must be one of it's candidates) to the empty cell at row, col.
+ */
+void scratch_place(ScratchBoard* s, int row, int col, int value);
+
+/*
+ * Empties the cell at row, col.
+ */
+void scratch_clear(ScratchBoard* s, int row, int col);
+
+#endif /* SCRATCH_H_ */
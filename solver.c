@@ -10,9 +10,11 @@
 #include <errno.h>
 
 #include "game.h"
+#include "solver.h"
 #include "board_utils.h"
 #include "stack.h"
-#include "gurobi_utils.h"
+#include "scratch.h"
+#include "backend.h"
 
 
 /*
@@ -22,7 +24,6 @@
  * returns 1 if legal, 0 if not
  */
 int check_valid_value(Board* b, int value, int row, int col, int only_fixed){
-	Cell** game_board = b->current_board;
 	int block_rows = b->block_rows;
 	int block_cols = b->block_cols;
 	int i, j;
@@ -35,16 +36,31 @@ int check_valid_value(Board* b, int value, int row, int col, int only_fixed){
 	if(value == 0)
 		return 1;
 
+	/*
+	 * if the cell doesn't hold value itself, the used values masks of its units answer directly
+	 */
+	if(only_fixed == 0 && get_cell_value(b, row, col) != value){
+		if(mask_has(&b->rows_used[row], value) || mask_has(&b->cols_used[col], value) ||
+				mask_has(&b->blocks_used[get_block_index(b, row, col)], value))
+			return 0;
+		return 1;
+	}
+	/*
+	 * if it does, the value counts of its units tell if another cell has it too
+	 */
+	if(only_fixed == 0)
+		return !is_value_repeated(b, row, col);
+
 	/*
 	 * check for exiting cell with same value in same row or column
 	 */
 	for( i = 0; i < board_size; i++ ){
-		if(game_board[row][i].value == value && i != col){
-			if(only_fixed == 0 || game_board[row][i].isFixed == 1)
+		if(get_cell_value(b, row, i) == value && i != col){
+			if(only_fixed == 0 || is_cell_fixed(b, row, i) == 1)
 				return 0;
 		}
-		if(game_board[i][col].value == value && i != row){
-			if(only_fixed == 0 || game_board[i][col].isFixed == 1)
+		if(get_cell_value(b, i, col) == value && i != row){
+			if(only_fixed == 0 || is_cell_fixed(b, i, col) == 1)
 				return 0;
 		}
 	}
@@ -56,8 +72,8 @@ int check_valid_value(Board* b, int value, int row, int col, int only_fixed){
 	block_start_col = (col/block_cols) * block_cols;
 	for( i = block_start_row; i < (block_start_row + block_rows); i++){
 		for( j = block_start_col; j < (block_start_col + block_cols); j++){
-			if(game_board[i][j].value == value && (i != row || j != col)){
-				if(only_fixed == 0 || game_board[i][j].isFixed == 1)
+			if(get_cell_value(b, i, j) == value && (i != row || j != col)){
+				if(only_fixed == 0 || is_cell_fixed(b, i, j) == 1)
 					return 0;
 			}
 		}
@@ -73,44 +89,24 @@ int check_valid_value(Board* b, int value, int row, int col, int only_fixed){
  * Returns 1 if no errors found. 0 if cells were marked.
  * Fixed cells can not be erroneous (so they are not marked).
  */
-/*int mark_erroneous_cells(Cell** game_board,int block_rows,int block_cols,int row, int col){*/
 int mark_erroneous_cells(Board* board, int row, int col){
-	Cell** game_board = board->current_board;
-	Cell* checked_cell = &(game_board[row][col]);
 	int board_size = board->board_size;
 	int i, j;
-	int temp;
 	int block_rows = board->block_rows;
 	int block_cols = board->block_cols;
 	int block_start_row, block_start_col;
 
-	/*if(value == 0)
-		return 1;*/
-	if(game_board[row][col].isFixed == 1)
+	if(is_cell_fixed(board, row, col) == 1)
 		return 1;
 	/*
 	 * check for clash in same row or column
 	 */
 	for( i = 0; i < board_size; i++ ){
-		temp = game_board[row][i].value;
-		game_board[row][i].value = 0;
-		if(game_board[row][i].isFixed == 0){
-			if(check_valid_value(board, temp, row, i, 0) == 1)
-				game_board[row][i].isError = 0;
-			else
-				game_board[row][i].isError = 1;
-		}
-		game_board[row][i].value = temp;
+		if(is_cell_fixed(board, row, i) == 0)
+			set_cell_error(board, row, i, is_value_repeated(board, row, i));
 
-		temp = game_board[i][col].value;
-		game_board[i][col].value = 0;
-		if(i != row && game_board[i][col].isFixed == 0){
-			if(check_valid_value(board, temp, i, col, 0) == 1)
-				game_board[i][col].isError = 0;
-			else
-				game_board[i][col].isError = 1;
-		}
-		game_board[i][col].value = temp;
+		if(i != row && is_cell_fixed(board, i, col) == 0)
+			set_cell_error(board, i, col, is_value_repeated(board, i, col));
 	}
 
 	/*
@@ -120,62 +116,42 @@ int mark_erroneous_cells(Board* board, int row, int col){
 	block_start_col = (col/block_cols) * block_cols;
 	for( i = block_start_row; i < (block_start_row + block_rows); i++){
 		for( j = block_start_col; j < (block_start_col + block_cols); j++){
-			if( (i != row || j != col) && (game_board[i][j].isFixed == 0) ){
-				temp = game_board[i][j].value;
-				game_board[i][j].value = 0;
-				if(check_valid_value(board, temp, i, j, 0) == 1)
-					game_board[i][j].isError = 0;
-				else
-					game_board[i][j].isError = 1;
-				game_board[i][j].value = temp;
-			}
+			if( (i != row || j != col) && (is_cell_fixed(board, i, j) == 0) )
+				set_cell_error(board, i, j, is_value_repeated(board, i, j));
 		}
 	}
-	if(checked_cell->isError == 1)
+	if(is_cell_error(board, row, col) == 1)
 		return 0;
 	return 1;
 }
 
 
 /*
- * Function checks given board for erroneous cells.
+ * Function checks given board for erroneous cells (by the board's count of them).
  * Returns 1 if there are errors, 0 if there are none.
  */
 int check_board_errors(Board* b){
-	int i,j;
-	for(i = 0; i < b->board_size; i++)
-		for(j = 0; j < b->board_size; j++)
-			if(b->current_board[i][j].isError == 1)
-				return 1;
-
-	return 0;
+	return b->num_errors > 0;
 }
 
-/*.
+/*
  * Get's a certain cell in game board, and returns list of possible valid options for that cell.
  * At options[0] is the amount of options found
- * returned value needs to be freed after use!!!
+ * The list is taken from the given arena (board_size + 1 ints at most), and is released with it.
  */
-int* generate_options(Board* b, int row, int col){
+int* generate_options(Board* b, int row, int col, Arena* arena){
 	int* options;
-	int value;
+	int value = 0;
 	int count = 0;
-	/*printf("checking col: %d row: %d\n",col+1,row+1);*/
-	options = (int*) malloc(10 * sizeof(int));
-	if(options == NULL){
-		printf(MALLOC_ERROR);
-		exit(0);
-	}
-	for(value = 1; value <= b->board_size; value++){
-		if(check_valid_value(b,value,row,col,0) == 1){
-			/*printf("  value %d is legal.\n",value);*/
-			count++;
-			options[count] = value;
-		}
+	ValueMask candidates;
+
+	get_cell_candidates(b, row, col, &candidates);
+	options = (int*) arena_alloc(arena, (mask_count(&candidates) + 1) * sizeof(int));
+	while((value = mask_next(&candidates, value)) != 0){
+		count++;
+		options[count] = value;
 	}
 	options[0] = count;
-	if(count < 9)
-		options = realloc(options,(count+1)*sizeof(int));
 	return options;
 }
 
@@ -190,142 +166,601 @@ void remove_option(int* options, int index_chosen){
 	options[0]--;
 }
 
+long last_search_nodes = 0;
+
+
+/*
+ * Removes the cell from the bucket list it is in.
+ */
+void bucket_remove(CandidateIndex* index, int cell){
+	int count = index->count[cell];
+	if(index->prev[cell] != -1)
+		index->next[index->prev[cell]] = index->next[cell];
+	else
+		index->bucket_head[count] = index->next[cell];
+	if(index->next[cell] != -1)
+		index->prev[index->next[cell]] = index->prev[cell];
+}
+
+/*
+ * Adds the cell to the bucket list of its current count.
+ */
+void bucket_insert(CandidateIndex* index, int cell){
+	int count = index->count[cell];
+	index->prev[cell] = -1;
+	index->next[cell] = index->bucket_head[count];
+	if(index->bucket_head[count] != -1)
+		index->prev[index->bucket_head[count]] = cell;
+	index->bucket_head[count] = cell;
+}
+
+/*
+ * Adds delta to the places of value in the row, column and block of the cell at row, col,
+ * after value stopped (delta == -1) or started (delta == 1) being valid for the cell.
+ * Entries that drop to 1 or 0 are added to the index's pending list.
+ */
+void update_places(CandidateIndex* index, ScratchBoard* s, int row, int col, int value, int delta){
+	int units[3];
+	int i, entry;
+
+	scratch_cell_units(s, row, col, units);
+	for(i = 0; i < 3; i++){
+		entry = units[i] * s->board_size + value - 1;
+		index->places[entry] += delta;
+		if(delta > 0 || index->places[entry] > 1)
+			continue;
+		if(index->num_pending == index->pending_size){
+			index->pending_size *= 2;
+			index->pending = (int*) realloc(index->pending, index->pending_size * sizeof(int));
+			if(index->pending == NULL){
+				printf(MALLOC_ERROR);
+				exit(0);
+			}
+		}
+		index->pending[index->num_pending++] = entry;
+	}
+}
+
+/*
+ * Updates a single neighbour of a cell that value was entered to (delta == -1)
+ * or removed from (delta == 1). Must be called while value is not in the cell's units.
+ */
+void update_peer(CandidateIndex* index, ScratchBoard* s, int row, int col, int value, int delta){
+	int cell = row * s->board_size + col;
+
+	if(s->values[cell] != 0)
+		return;
+	index->degree[cell] += delta;
+	if(!scratch_is_candidate(s, row, col, value))
+		return;
+	bucket_remove(index, cell);
+	index->count[cell] += delta;
+	bucket_insert(index, cell);
+	update_places(index, s, row, col, value, delta);
+}
+
+/*
+ * Updates the neighbours (same row, column or block) of the cell at row, col,
+ * after value was entered to it (delta == -1) or removed from it (delta == 1).
+ */
+void update_peers(CandidateIndex* index, ScratchBoard* s, int row, int col, int value, int delta){
+	int i, j;
+	int block_start_row = (row / s->block_rows) * s->block_rows;
+	int block_start_col = (col / s->block_cols) * s->block_cols;
+
+	for(i = 0; i < s->board_size; i++){
+		if(i != col)
+			update_peer(index, s, row, i, value, delta);
+		if(i != row)
+			update_peer(index, s, i, col, value, delta);
+	}
+	for(i = block_start_row; i < block_start_row + s->block_rows; i++)
+		for(j = block_start_col; j < block_start_col + s->block_cols; j++)
+			if(i != row && j != col)
+				update_peer(index, s, i, j, value, delta);
+}
+
 /*
- * Given a board, the function finds the first cell that is empty,
- * and puts it's row and col values in the given pointers.
- * If no empty cell exists, the functions returns 0. If it does, returns 1.
+ * Adds delta to the places of all the valid values of the empty cell at row, col,
+ * after the cell was filled (delta == -1) or cleared (delta == 1).
  */
-int find_first_empty_cell(Board* b, int* row, int* col){
-	int i,j;
-	for( i = 0; i < b->board_size; i++ ){
-		for( j = 0; j < b->board_size; j++ ){
-			if( b->current_board[i][j].value == 0 ){
-				*row = i;
-				*col = j;
-				return 1;
+void update_cell_places(CandidateIndex* index, ScratchBoard* s, int row, int col, int delta){
+	ValueMask candidates;
+	int value = 0;
+	scratch_candidates(s, row, col, &candidates);
+	while((value = mask_next(&candidates, value)) != 0)
+		update_places(index, s, row, col, value, delta);
+}
+
+/*
+ * Creates a CandidateIndex for all the empty cells of the given board.
+ */
+CandidateIndex* create_candidate_index(ScratchBoard* s){
+	CandidateIndex* index;
+	ValueMask candidates[MAX_MASK_VALUES];
+	int counts[MAX_MASK_VALUES];
+	int board_size = s->board_size;
+	int num_cells = board_size * board_size;
+	int row, col, i, j, cell, value;
+	int block_start_row, block_start_col;
+
+	index = (CandidateIndex*) malloc(sizeof(CandidateIndex));
+	if(index == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	index->count = (int*) malloc(num_cells * sizeof(int));
+	index->degree = (int*) calloc(num_cells, sizeof(int));
+	index->next = (int*) malloc(num_cells * sizeof(int));
+	index->prev = (int*) malloc(num_cells * sizeof(int));
+	index->bucket_head = (int*) malloc((board_size + 1) * sizeof(int));
+	index->places = (int*) calloc(3 * num_cells, sizeof(int));
+	index->pending_size = 3 * num_cells;
+	index->pending = (int*) malloc(index->pending_size * sizeof(int));
+	if(!index->count || !index->degree || !index->next || !index->prev || !index->bucket_head ||
+			!index->places || !index->pending){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	index->num_pending = 0;
+	for(i = 0; i <= board_size; i++)
+		index->bucket_head[i] = -1;
+
+	for(row = 0; row < board_size; row++){
+		scratch_row_candidates(s, row, candidates, counts);
+		for(col = 0; col < board_size; col++){
+			if(s->values[row * board_size + col] != 0)
+				continue;
+			cell = row * board_size + col;
+			index->count[cell] = counts[col];
+			value = 0;
+			while((value = mask_next(&candidates[col], value)) != 0)
+				update_places(index, s, row, col, value, 1);
+
+			block_start_row = (row / s->block_rows) * s->block_rows;
+			block_start_col = (col / s->block_cols) * s->block_cols;
+			for(i = 0; i < board_size; i++){
+				if(i != col && s->values[row * board_size + i] == 0)
+					index->degree[cell]++;
+				if(i != row && s->values[i * board_size + col] == 0)
+					index->degree[cell]++;
 			}
+			for(i = block_start_row; i < block_start_row + s->block_rows; i++)
+				for(j = block_start_col; j < block_start_col + s->block_cols; j++)
+					if(i != row && j != col && s->values[i * board_size + j] == 0)
+						index->degree[cell]++;
+
+			bucket_insert(index, cell);
 		}
 	}
-	return 0;
+	return index;
+}
+
+/*
+ * Destroys properly a given CandidateIndex, freeing all allocated resources.
+ */
+void destroy_candidate_index(CandidateIndex* index){
+	free(index->count);
+	free(index->degree);
+	free(index->next);
+	free(index->prev);
+	free(index->bucket_head);
+	free(index->places);
+	free(index->pending);
+	free(index);
+}
+
+/*
+ * Enters value to the empty cell at row, col and updates the index.
+ */
+void index_place(CandidateIndex* index, ScratchBoard* s, int row, int col, int value){
+	bucket_remove(index, row * s->board_size + col);
+	update_cell_places(index, s, row, col, -1);
+	update_peers(index, s, row, col, value, -1);
+	scratch_place(s, row, col, value);
+}
+
+/*
+ * Removes the value of the cell at row, col and updates the index.
+ * Cells must be cleared in the opposite order they were placed, so the cell's
+ * own count and degree are still the ones it had when it was filled.
+ */
+void index_clear(CandidateIndex* index, ScratchBoard* s, int row, int col){
+	int value = s->values[row * s->board_size + col];
+	scratch_clear(s, row, col);
+	update_peers(index, s, row, col, value, 1);
+	update_cell_places(index, s, row, col, 1);
+	bucket_insert(index, row * s->board_size + col);
+}
+
+/*
+ * Finds the empty cell with the fewest valid values. Ties are broken by the cell
+ * with the most empty neighbours, as filling it constrains the most other cells.
+ * Only the first TIE_BREAK_SCAN_LIMIT cells of the tie are compared: on big boards with few
+ * values filled the tie can hold most of the board, and scanning all of it at every node costs
+ * more than a slightly worse pick of the cell to branch on.
+ * Puts it's row and col in the given pointers, and returns its amount of valid values.
+ * If there are no empty cells, returns -1.
+ */
+int find_most_constrained_cell(CandidateIndex* index, ScratchBoard* s, int* row, int* col){
+	int count, cell, scanned, best = -1;
+
+	for(count = 0; count <= s->board_size; count++){
+		if(index->bucket_head[count] == -1)
+			continue;
+		scanned = 0;
+		for(cell = index->bucket_head[count]; cell != -1 && scanned < TIE_BREAK_SCAN_LIMIT;
+				cell = index->next[cell], scanned++)
+			if(best == -1 || index->degree[cell] > index->degree[best])
+				best = cell;
+		*row = best / s->board_size;
+		*col = best % s->board_size;
+		return count;
+	}
+	return -1;
+}
+
+/*
+ * Creates a Search that counts the solutions of the given board's current state.
+ * The board is only read here, the search fills and clears cells on a ScratchBoard of its own.
+ * If relabel == 1, the values missing from the board are treated as interchangeable, and only one
+ * solution out of every (amount of missing values)! that differ by relabelling them is counted.
+ * The board must not have erroneous cells.
+ */
+Search* create_search(Board* b, int relabel){
+	int value;
+	int num_empty = b->num_empty_cells_current;
+	Search* search = (Search*) malloc(sizeof(Search));
+	if(search == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	search->untried = (ValueMask*) malloc((num_empty + 1) * sizeof(ValueMask));
+	search->trail = (int*) malloc((num_empty + 1) * sizeof(int));
+	search->trail_mark = (int*) malloc((num_empty + 1) * sizeof(int));
+	if(search->untried == NULL || search->trail == NULL || search->trail_mark == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	search->scratch = create_scratch_board(b);
+	search->index = create_candidate_index(search->scratch);
+	search->stack = initialize_stack(num_empty);
+	search->trail_size = 0;
+	search->started = 0;
+	search->propagation = use_propagation;
+	search->num_sol = 0;
+	search->nodes = 0;
+	search->solution = NULL;
+	mask_clear(&search->relabel);
+	if(relabel)
+		for(value = 1; value <= b->board_size; value++)
+			if(search->scratch->value_count[value] == 0)
+				mask_add(&search->relabel, value);
+	return search;
+}
+
+/*
+ * Destroys properly a given Search, freeing all allocated resources.
+ */
+void destroy_search(Search* search){
+	destroy_stack(search->stack);
+	destroy_candidate_index(search->index);
+	destroy_scratch_board(search->scratch);
+	free(search->untried);
+	free(search->trail);
+	free(search->trail_mark);
+	free(search);
+}
+
+/*
+ * Fills the empty cell at row, col with value as a propagated (not chosen) cell.
+ */
+void trail_place(Search* search, int row, int col, int value){
+	index_place(search->index, search->scratch, row, col, value);
+	search->trail[search->trail_size++] = row * search->scratch->board_size + col;
 }
 
 /*
- * Function is given a board and a cell's row and col;
- * It finds and returns the next (bigger) valid value to put in the cell, that is closest
- * to the current value.
- * If no bigger value is valid, returns 0.
- * for use in num_solutions
+ * Clears the propagated cells, newest first, until only mark of them are left.
  */
-int find_next_valid_value(Board* b, int row, int col){
-	int current_value = b->current_board[row][col].value;
-	int next_value;
-	for(next_value = current_value + 1; next_value <= b->board_size; next_value++){
-		/*printf("checking %d, ",next_value);*/
-		if(check_valid_value(b,next_value,row,col,0) == 1){
-			/*printf("\nfound next valid: %d\n",next_value);*/
-			return next_value;}
-	}
-	/*printf("\nnothing is valid,returning 0\n");*/
-	return 0;
+void trail_undo(Search* search, int mark){
+	int cell;
+	int board_size = search->scratch->board_size;
+	while(search->trail_size > mark){
+		cell = search->trail[--search->trail_size];
+		index_clear(search->index, search->scratch, cell / board_size, cell % board_size);
+	}
 }
 
+/*
+ * Adds to the pending list every unit value that has at most one valid place,
+ * so propagation checks the hidden singles already in the board.
+ */
+void queue_all_places(CandidateIndex* index, ScratchBoard* s){
+	int entry;
+	int num_entries = 3 * s->board_size * s->board_size;
+	index->num_pending = 0;
+	for(entry = 0; entry < num_entries; entry++)
+		if(index->places[entry] <= 1)
+			index->pending[index->num_pending++] = entry;
+}
 
 /*
- * Functions recieves a board, and returns the number of possible solutions for
- * the board's current state, using Exhaustive Backtracking on a Stack.
- * should work on a copy
+ * Repeatedly fills all cells that have a single valid value (naked singles), and all values
+ * that have a single valid cell in a row, column or block (hidden singles), until none are left.
+ * Every filled cell is recorded on the search's trail.
+ * Returns 0 if the board can't be completed (an empty cell with no valid values, or a unit that
+ * has no valid cell for a value it's missing), 1 otherwise.
  */
-int num_solutions(Board* b){
-	Stack* stack;
+int propagate(Search* search){
+	CandidateIndex* index = search->index;
+	ScratchBoard* s = search->scratch;
+	ValueMask candidates;
+	int board_size = s->board_size;
+	int cell, entry, unit, value, k;
+	int row = 0, col = 0;
+
+	while(1){
+		if(index->bucket_head[0] != -1)
+			return 0;
+
+		if((cell = index->bucket_head[1]) != -1){
+			scratch_candidates(s, cell / board_size, cell % board_size, &candidates);
+			trail_place(search, cell / board_size, cell % board_size, mask_next(&candidates, 0));
+			continue;
+		}
+
+		if(index->num_pending == 0)
+			return 1;
+		entry = index->pending[--index->num_pending];
+		unit = entry / board_size;
+		value = entry % board_size + 1;
+		if(index->places[entry] > 1 || mask_has(&s->units_used[unit], value))
+			continue;
+		if(index->places[entry] == 0)
+			return 0;
+		for(k = 0; k < board_size; k++){
+			scratch_unit_cell(s, unit, k, &row, &col);
+			if(s->values[row * board_size + col] == 0 && scratch_is_candidate(s, row, col, value))
+				break;
+		}
+		trail_place(search, row, col, value);
+	}
+}
+
+/*
+ * Removes from values all the search's relabelled values that aren't on the board yet,
+ * other than the smallest of them. Any of them leads to the same amount of solutions,
+ * as swapping two of them maps the solutions of one to the solutions of the other.
+ */
+void restrict_relabelled(Search* search, ValueMask* values){
+	int value = 0, first = 0;
+	while((value = mask_next(&search->relabel, value)) != 0){
+		if(search->scratch->value_count[value] != 0)
+			continue;
+		if(first == 0)
+			first = value;
+		else
+			mask_remove(values, value);
+	}
+}
+
+/*
+ * Does a single step of the given search: propagates (if search->propagation is on), then goes
+ * one cell deeper (to the empty cell with the fewest valid values, ties broken by the most
+ * empty neighbours), or counts a solution / dead end and backtracks to the deepest cell that
+ * still has a value to try. Cells filled by propagation are cleared when backtracking past
+ * the cell that caused them.
+ * Returns 1 once all fill options were gone through (the search's ScratchBoard is then back
+ * to it's state when the search was created), 0 otherwise.
+ */
+int search_step(Search* search){
+	ScratchBoard* s = search->scratch;
 	StackElem* elem;
-	int num_sol = 0;
-	int next_value;
+	ValueMask* untried;
 	int row, col;
+	int value;
+	int depth;
+	int consistent = 1;
 
-	/* ====================================== */
+	if(!search->started){
+		search->started = 1;
+		queue_all_places(search->index, s);
+	}
+	if(search->propagation)
+		consistent = propagate(search);
+	else
+		search->index->num_pending = 0;
+
+	if(consistent && s->num_empty == 0){
+		search->num_sol++;
+		if(search->solution != NULL && search->num_sol == 1)
+			memcpy(search->solution, s->values, s->board_size * s->board_size * sizeof(int));
+	}
+	else if(consistent && find_most_constrained_cell(search->index, s, &row, &col) > 0){
+		depth = search->stack->count;
+		untried = &search->untried[depth];
+		scratch_candidates(s, row, col, untried);
+		restrict_relabelled(search, untried);
+		value = mask_next(untried, 0);
+		mask_remove(untried, value);
+		search->trail_mark[depth] = search->trail_size;
+		push(search->stack, row, col, value);
+		index_place(search->index, s, row, col, value);
+		search->nodes++;
+		return 0;
+	}
+
+	/*backtracking*/
+	while(!is_empty(search->stack)){
+		elem = top(search->stack);
+		depth = search->stack->count - 1;
+		trail_undo(search, search->trail_mark[depth]);
+		index_clear(search->index, s, elem->row, elem->col);
+		untried = &search->untried[depth];
+		if((value = mask_next(untried, 0)) != 0){
+			mask_remove(untried, value);
+			elem->value = value;
+			index_place(search->index, s, elem->row, elem->col, value);
+			search->nodes++;
+			return 0;
+		}
+		pop(search->stack);
+	}
+	/*finished going through all fill options*/
+	trail_undo(search, 0);
+	search->started = 0;
+	return 1;
+}
+
+
+/*
+ * Function recieves a board, and counts the solutions of the board's current state
+ * with a single Search, using Exhaustive Backtracking on a Stack.
+ * Each step branches on the empty cell with the fewest valid values (ties broken by
+ * the most empty neighbours), after filling the forced cells if use_propagation is on.
+ * The stack keeps the chosen cell of each depth. The search runs on a ScratchBoard,
+ * so the given board is not changed.
+ * If relabel == 1, counts only one solution out of every group that differ by relabelling the
+ * values missing from the board (see create_search), so the amount of solutions is the returned
+ * amount times (amount of missing values)!.
+ */
+unsigned long count_search(Board* b, int relabel){
+	Search* search;
+	unsigned long num_sol;
 
+	last_search_nodes = 0;
 	if(check_board_errors(b) == 1){
 	/*if the board has errors then there is no solution*/
 		return 0;
 	}
 
-	if(b->num_empty_cells_current == 0)
-	/*if there are no errors and no empty cells, then there is one solution*/
-		return 1;
+	search = create_search(b, relabel);
+	while(search_step(search) == 0);
+	num_sol = search->num_sol;
+	last_search_nodes = search->nodes;
+	destroy_search(search);
+	return num_sol;
+}
 
-	/* find first empty cell, find smallest option to fill it with */
-	find_first_empty_cell(b, &row, &col);
-	next_value = find_next_valid_value(b,row,col);
-	if(next_value == 0){
-		return 0;
+/*
+ * Clears all cells the search filled (by choice or by propagation), bringing the search's
+ * ScratchBoard back to it's state when the search was created. For stopping a search before it finished.
+ */
+void search_unwind(Search* search){
+	StackElem* elem;
+	while(!is_empty(search->stack)){
+		trail_undo(search, search->trail_mark[search->stack->count - 1]);
+		elem = pop(search->stack);
+		index_clear(search->index, search->scratch, elem->row, elem->col);
 	}
+	trail_undo(search, 0);
+	search->started = 0;
+}
 
-	stack = initialize_stack();
-	push(stack, row, col, next_value);
-
-	while(!is_empty(stack)){
-		elem = top(stack);
-		set_value_simple(b,elem->row,elem->col,elem->value);
-		/*printBoard(b,0);
-		printf("count of stack: %d\n",stack->count);
-		print_Stack(stack);*/
-
-		if(b->num_empty_cells_current == 0){
-		/*Found a solution. now we try to find more by backtracking and incrementing*/
-			num_sol++;
-			while( ((next_value = find_next_valid_value(b,elem->row,elem->col)) == 0) && (is_empty(stack) != 1) ){
-				set_value_simple(b,elem->row,elem->col,0);
-				pop(stack);
-				free(elem);
-				elem = top(stack);
-				if(elem == NULL)
-					break;
-			}
-			if( (is_empty(stack)) && (next_value == 0) ){
-			/*finished going through all fill options*/
-				continue;
-			}
-			pop(stack);
-			push(stack, elem->row, elem->col, next_value);
-			free(elem);
-		}
-		else{
-		/*Board not full yet. find next empty cell, and push it to stack with next valid value*/
-			find_first_empty_cell(b, &row, &col);
-			next_value = find_next_valid_value(b, row, col);
-			if(next_value != 0)
-				push(stack, row, col, next_value);
-			else{
-				while( ((next_value = find_next_valid_value(b,elem->row,elem->col)) == 0) && !is_empty(stack) ){
-					set_value_simple(b,elem->row,elem->col,0);
-					pop(stack);
-					free(elem);
-					elem = top(stack);
-					if(elem == NULL)
-						break;
-				}
-				if( (is_empty(stack)) && (next_value == 0) ){
-				/*finished going through all fill options*/
-					continue;
-				}
-				else{
-					if(elem->row == stack->top->row && elem->col == stack->top->col)
-						pop(stack);
-					push(stack, elem->row, elem->col, next_value);
-					free(elem);
-				}
-			}
+/*
+ * Makes the search choose value for the empty cell at row, col as it's next depth, as if the
+ * search chose it itself (propagating first if search->propagation is on), with untried as the
+ * values of the cell that are left to try. For continuing a search from a saved stack.
+ * Returns 1 on success, 0 if value isn't valid for the cell at that point of the search,
+ * or if untried has a value other than value's that isn't valid for it either
+ * (placing such a value when backtracking would corrupt the search's masks and counts).
+ */
+int search_replay(Search* search, int row, int col, int value, ValueMask* untried){
+	ScratchBoard* s = search->scratch;
+	int depth = search->stack->count;
+	int untried_value;
+
+	if(!search->started){
+		search->started = 1;
+		queue_all_places(search->index, s);
+	}
+	if(search->propagation && !propagate(search))
+		return 0;
+	if(row < 0 || row >= s->board_size || col < 0 || col >= s->board_size ||
+			value < 1 || value > s->board_size ||
+			s->values[row * s->board_size + col] != 0 || !scratch_is_candidate(s, row, col, value))
+		return 0;
+	for(untried_value = mask_next(untried, 0); untried_value != 0; untried_value = mask_next(untried, untried_value))
+		if(untried_value == value || !scratch_is_candidate(s, row, col, untried_value))
+			return 0;
+
+	search->untried[depth] = *untried;
+	search->trail_mark[depth] = search->trail_size;
+	push(search->stack, row, col, value);
+	index_place(search->index, s, row, col, value);
+	return 1;
+}
+
+/*
+ * Function recieves a board, and returns the number of possible solutions for the board's
+ * current state found by the backtracking search, but stops counting once limit solutions
+ * were found (and then returns limit). limit <= 0 means no limit.
+ */
+int search_count_upto(Board* b, int limit){
+	Search* search;
+	int num_sol;
 
+	if(check_board_errors(b) == 1)
+		return 0;
+
+	search = create_search(b, 0);
+	while(search_step(search) == 0){
+		if(limit > 0 && search->num_sol >= (unsigned long) limit){
+			search_unwind(search);
+			break;
 		}
 	}
-
-	destroy_stack(stack);
+	num_sol = (int) search->num_sol;
+	last_search_nodes = search->nodes;
+	destroy_search(search);
 	return num_sol;
 }
 
+/*
+ * Function uses the backtracking search (with propagation) to try and find a solution to the given board.
+ * If a solution is found, returns 1. If there is no solution, returns -1.
+ * When given save_solution as 1, the found solution (if exists) is saved on the given board.
+ */
+int find_exact_solution(Board* board, int save_solution){
+	Search* search;
+	int* solution;
+	int row, col;
+	int board_size = board->board_size;
+	int found;
+
+	if(check_board_errors(board) == 1)
+		return -1;
+
+	solution = (int*) malloc(board_size * board_size * sizeof(int));
+	if(solution == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
+	search = create_search(board, 0);
+	search->propagation = 1;
+	search->solution = solution;
+	while(search_step(search) == 0){
+		if(search->num_sol >= 1){
+			search_unwind(search);
+			break;
+		}
+	}
+	found = search->num_sol >= 1;
+	destroy_search(search);
+
+	if(found && save_solution)
+		for(row = 0; row < board_size; row++)
+			for(col = 0; col < board_size; col++)
+				if(get_cell_value(board, row, col) == 0)
+					set_value_simple(board, row, col, solution[row * board_size + col]);
+	free(solution);
+	return found ? 1 : -1;
+}
+
 /*
  * Function tries (up to 1000 times) to generate a random solvable board into the given board.
- * x: amount of random cells to randomly fill before running ilp.
+ * x: amount of random cells to randomly fill before running the solver (see find_solution).
  * y: amount of cells to leave filled in the final board.
  * Returns 1 if successful, 0 otherwise.
  * For use of the GENERATE command.
@@ -339,6 +774,7 @@ int generate(Board* board,int x, int y){
 	int cells_cleared = 0;
 	int board_size = board->board_size;
 	int* options;
+	Arena* options_arena;
 	int index_chosen;
 	int *changed_rows, *changed_cols;
 	MovesList* moves;
@@ -360,8 +796,8 @@ int generate(Board* board,int x, int y){
 		return 0;
 	}
 
-	if (validate_board(board) != 1) {
-		printf("Error: The initial board can not be validated, so can not generate a new board from it.\n");
+	if (is_feasible(board) != 1) {
+		printf("Error: The initial board has no solution, so can not generate a new board from it.\n");
 		return 0;
 	}
 
@@ -373,16 +809,20 @@ int generate(Board* board,int x, int y){
 		exit(0);
 	}
 
-	copy_board = copy_Board(board);
+	copy_board = snapshot_board(board);
+	/*room for the options of every cell filled in a try, and of the one it may get stuck on.
+	 * unlike the ilp's, this arena is per call: reset for every try and destroyed before returning*/
+	options_arena = create_arena((x + 1) * arena_size_of((board_size + 1) * sizeof(int)));
 
 	for(count_iter = 0; count_iter < 1000; count_iter++){
 		cells_filled = 0;
+		arena_reset(options_arena);
 		while(cells_filled < x){
 			rand_row = rand() % board_size;
 			rand_col = rand() % board_size;
 
-			if (board->current_board[rand_row][rand_col].value == 0) {
-				options = generate_options(board,rand_row,rand_col);
+			if (get_cell_value(board, rand_row, rand_col) == 0) {
+				options = generate_options(board,rand_row,rand_col,options_arena);
 
 				if(options[0] == 0){
 					/*stuck with a cell with no legal value. starting over, (raising count_iter).*/
@@ -392,7 +832,6 @@ int generate(Board* board,int x, int y){
 						changed_cols[i] = 0;
 					}
 					cells_filled = 0;
-					free(options);
 					break;
 				}
 
@@ -405,7 +844,6 @@ int generate(Board* board,int x, int y){
 				changed_rows[cells_filled] = rand_row;
 				changed_cols[cells_filled] = rand_col;
 				cells_filled++;
-				free(options);
 				}
 			}
 
@@ -413,9 +851,10 @@ int generate(Board* board,int x, int y){
 				continue;
 
 
-			j = find_ILP_solution(board, 1);
+			j = find_solution(board, 1);
 			if (j != 1) { /*The board has no solution. restart.*/
-				printf("ilp failed and returnd %d\n",j);
+				if (j == 0)
+					printf("The solver failed and returned %d\n",j);
 				for (k = 0; k < cells_filled; k++) {
 					set_value_simple(board, changed_rows[k], changed_cols[k], 0);
 					changed_rows[k] = 0;
@@ -428,6 +867,7 @@ int generate(Board* board,int x, int y){
 		}
 
 	/*printf("finished loops- count_iter: %d, cells_filled: %d\n",count_iter,cells_filled);*/
+	destroy_arena(options_arena);
 	if(count_iter == 1000 && cells_filled == 0 && x != 0){
 		destroyBoard(copy_board);
 		free(changed_cols);
@@ -441,7 +881,7 @@ int generate(Board* board,int x, int y){
 		/*Clearing all but y cells from the board*/
 		rand_row = rand() % board_size;
 		rand_col = rand() % board_size;
-		if(board->current_board[rand_row][rand_col].value != 0){
+		if(get_cell_value(board, rand_row, rand_col) != 0){
 			set_value_simple(board, rand_row, rand_col, 0);
 			cells_cleared++;
 		}
@@ -451,8 +891,8 @@ int generate(Board* board,int x, int y){
 	moves = initialize_move_list();
 	for(i = 0; i < board_size; i++)
 		for(j = 0; j < board_size; j++)
-			if(board->current_board[i][j].value != copy_board->current_board[i][j].value)
-				add_move(moves, i, j, copy_board->current_board[i][j].value, board->current_board[i][j].value);
+			if(get_cell_value(board, i, j) != get_cell_value(copy_board, i, j))
+				add_move(moves, i, j, get_cell_value(copy_board, i, j), get_cell_value(board, i, j));
 
 	add_turn(board->turns, moves);
 
@@ -7,7 +7,83 @@
 #define SOLVER_H_
 
 #include "game.h"
+#include "stack.h"
+#include "scratch.h"
+#include "arena.h"
 
+/* amount of cells with the fewest valid values that are compared by their degree, when picking
+ * the cell to branch on */
+#define TIE_BREAK_SCAN_LIMIT 8
+
+/*
+ * Structure: CandidateIndex
+ * 		Used by count_search to pick the next cell to branch on without scanning the ScratchBoard.
+ * 		Cells are identified by row * board_size + col.
+ *
+ * 		count: for each empty cell, the amount of valid values it has.
+ * 		degree: for each empty cell, the amount of empty cells in its row, column and block.
+ * 		bucket_head: for each amount k of valid values (0 to board_size), the first empty cell
+ * 		             that has exactly k valid values, or -1 if there is none.
+ * 		next, prev: the links of the cells in their bucket lists (-1 at the ends).
+ * 		places: for each unit (see scratch_unit_cell) and value, at unit * board_size + value - 1,
+ * 		        the amount of empty cells in the unit that the value is valid for.
+ * 		pending: places entries that dropped to 1 or 0, to be checked for hidden singles.
+ * 		num_pending, pending_size: the amount of entries in pending, and its allocated size.
+ */
+typedef struct candidate_index_t{
+	int* count;
+	int* degree;
+	int* bucket_head;
+	int* next;
+	int* prev;
+	int* places;
+	int* pending;
+	int num_pending;
+	int pending_size;
+} CandidateIndex;
+
+/*
+ * Structure: Search
+ * 		The state of an Exhaustive Backtracking count on a board (see count_search).
+ *
+ * 		scratch: the private copy of the searched board. Cells are filled and cleared on it
+ * 		         during the search, the board it was read from is not changed.
+ * 		index: the CandidateIndex of scratch's empty cells.
+ * 		stack: the cell and current value chosen at each depth of the search.
+ * 		untried: for each depth (0 is the bottom of the stack), the valid values
+ * 		         of that depth's cell that were not tried yet.
+ * 		trail: the cells filled by propagation (not by choice), in the order they were filled.
+ * 		trail_size: the amount of cells in trail.
+ * 		trail_mark: for each depth, the trail_size before that depth's cell was filled.
+ * 		started: 1 once the search took its first step, 0 before it and after it finished.
+ * 		propagation: 1 if the search fills forced cells before branching (use_propagation
+ * 		             when the search was created), 0 otherwise.
+ * 		relabel: the values that are interchangeable in every solution, as none of them
+ * 		         was on the board when the search was created. When choosing a value for a cell,
+ * 		         only the smallest of them that isn't on the board yet is tried, so only one
+ * 		         solution of every relabelling of these values is counted.
+ * 		num_sol: the amount of solutions found so far.
+ * 		nodes: the amount of cells filled by choice so far.
+ * 		solution: if not NULL, the first solution found is copied to it (values by cell).
+ */
+typedef struct search_t{
+	ScratchBoard* scratch;
+	CandidateIndex* index;
+	Stack* stack;
+	ValueMask* untried;
+	int* trail;
+	int trail_size;
+	int* trail_mark;
+	int started;
+	int propagation;
+	ValueMask relabel;
+	unsigned long num_sol;
+	long nodes;
+	int* solution;
+} Search;
+
+/* the amount of nodes the last backtracking count went through (for comparing propagation on / off) */
+extern long last_search_nodes;
 
 
 /*
@@ -19,13 +95,11 @@
 int check_valid_value(Board* b, int value, int row, int col, int only_fixed);
 
 /*
- * For use in random backtrack.
- * Get's a certain cell in game board, and returns list of possible options for that cell.
+ * Get's a certain cell in game board, and returns list of possible valid options for that cell.
  * At options[0] is the amount of options found
- * If is_random == 1: chooses only valid options. else: gives all options 1-9.
- * returned value needs to be freed after use!!!
+ * The list is taken from the given arena (board_size + 1 ints at most), and is released with it.
  */
-int* generate_options(Board* b, int row, int col, int is_random);
+int* generate_options(Board* b, int row, int col, Arena* arena);
 
 /*
  * Function checks and marks if the current value of a given cell (by row, col)
@@ -36,20 +110,89 @@ int* generate_options(Board* b, int row, int col, int is_random);
 int mark_erroneous_cells(Board* board, int row, int col);
 
 /*
- * Function checks given board for erroneous cells.
+ * Function checks given board for erroneous cells (by the board's count of them).
  * Returns 1 if there are errors, 0 if there are none.
  */
 int check_board_errors(Board* b);
 
 /*
- * Functions recieves a board, and returns the number of possible solutions for
- * the board's current state, using Exhaustive Backtracking
+ * Function recieves a board, and counts the solutions of the board's current state
+ * with a single Search, using Exhaustive Backtracking.
+ * Each step branches on the empty cell with the fewest valid values
+ * (ties broken by the most empty neighbours).
+ * If relabel == 1, counts only one solution out of every group that differ by relabelling the
+ * values missing from the board (see create_search), so the amount of solutions is the returned
+ * amount times (amount of missing values)!.
+ */
+unsigned long count_search(Board* b, int relabel);
+
+/*
+ * Function recieves a board, and returns the number of possible solutions for the board's
+ * current state found by the backtracking search, but stops counting once limit solutions
+ * were found (and then returns limit). limit <= 0 means no limit.
+ */
+int search_count_upto(Board* b, int limit);
+
+/*
+ * Creates a Search that counts the solutions of the given board's current state.
+ * The board is only read here, the search fills and clears cells on a ScratchBoard of its own.
+ * If relabel == 1, the values missing from the board are treated as interchangeable, and only one
+ * solution out of every (amount of missing values)! that differ by relabelling them is counted.
+ * The board must not have erroneous cells.
+ */
+Search* create_search(Board* b, int relabel);
+
+/*
+ * Destroys properly a given Search, freeing all allocated resources.
+ */
+void destroy_search(Search* search);
+
+/*
+ * Does a single step of the given search: propagates (if search->propagation is on), then goes
+ * one cell deeper, or counts a solution / dead end and backtracks. Returns 1 once all fill
+ * options were gone through (the search's ScratchBoard is then back to it's state when the
+ * search was created), 0 otherwise.
+ */
+int search_step(Search* search);
+
+/*
+ * Clears all cells the search filled (by choice or by propagation), bringing the search's
+ * ScratchBoard back to it's state when the search was created. For stopping a search before it finished.
+ */
+void search_unwind(Search* search);
+
+/*
+ * Makes the search choose value for the empty cell at row, col as it's next depth, as if the
+ * search chose it itself (propagating first if search->propagation is on), with untried as the
+ * values of the cell that are left to try. For continuing a search from a saved stack.
+ * Returns 1 on success, 0 if value isn't valid for the cell at that point of the search,
+ * or if untried has a value other than value's that isn't valid for it either
+ * (placing such a value when backtracking would corrupt the search's masks and counts).
+ */
+int search_replay(Search* search, int row, int col, int value, ValueMask* untried);
+
+/*
+ * Enters value to the empty cell at row, col of the search's ScratchBoard, and updates the search's index.
+ * For entering cells outside of the search's stack (see the "parallel" module).
+ */
+void index_place(CandidateIndex* index, ScratchBoard* s, int row, int col, int value);
+
+/*
+ * Removes the value of the cell at row, col and updates the index.
+ * Cells must be cleared in the opposite order they were placed.
+ */
+void index_clear(CandidateIndex* index, ScratchBoard* s, int row, int col);
+
+/*
+ * Function uses the backtracking search (with propagation) to try and find a solution to the given board.
+ * If a solution is found, returns 1. If there is no solution, returns -1.
+ * When given save_solution as 1, the found solution (if exists) is saved on the given board.
  */
-int num_solutions(Board* b);
+int find_exact_solution(Board* board, int save_solution);
 
 /*
  * Function tries (up to 1000 times) to generate a random solvable board into the given board.
- * x: amount of random cells to randomly fill before running ilp.
+ * x: amount of random cells to randomly fill before running the solver (see find_solution).
  * y: amount of cells to leave filled in the final board.
  * Returns 1 if successful, 0 otherwise.
  * For use of the GENERATE command.
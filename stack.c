@@ -13,18 +13,23 @@
 
 
 /*
- * Function that creates an empty Stack struct.
- * Initializes the amount of elements (count) to 0, and top element to NULL.
+ * Function that creates an empty Stack struct, with room for capacity elements
+ * (for num_solutions, the amount of empty cells). Initializes the amount of elements (count) to 0.
  * Returns a pointer to the stack.
  */
-Stack* initialize_stack(){
+Stack* initialize_stack(int capacity){
 	Stack* stack = (Stack*)malloc(sizeof(Stack));
 	if(stack == NULL){
 		printf(MALLOC_ERROR);
 		exit(0);
 	}
 	stack->count = 0;
-	stack->top = NULL;
+	stack->capacity = capacity > 0 ? capacity : 1;
+	stack->elems = (StackElem*)malloc(stack->capacity * sizeof(StackElem));
+	if(stack->elems == NULL){
+		printf(MALLOC_ERROR);
+		exit(0);
+	}
 	return stack;
 }
 
@@ -32,46 +37,43 @@ Stack* initialize_stack(){
  * Recieves a stack and safeley frees all related memory (including all elemants).
  */
 void destroy_stack(Stack* stk){
-	while(!is_empty(stk))
-		free(pop(stk));
-
+	free(stk->elems);
 	free(stk);
 }
 
 
 /*
- * Creates a new elem out of the given data, and puts it at top of the stack.
+ * Puts an elem of the given data at top of the stack.
  * Needs to get the wanted cell's row, column and value.
+ * The stack grows if it is full, so it is best created with the largest size it will reach.
  */
 void push(Stack* stk, int row, int col, int value){
-	StackElem* elem = (StackElem*)malloc(sizeof(StackElem));
-	if(elem == NULL){
-		printf(MALLOC_ERROR);
-		exit(0);
+	StackElem* elem;
+
+	if(stk->count == stk->capacity){
+		stk->capacity *= 2;
+		stk->elems = (StackElem*)realloc(stk->elems, stk->capacity * sizeof(StackElem));
+		if(stk->elems == NULL){
+			printf(MALLOC_ERROR);
+			exit(0);
+		}
 	}
+	elem = &stk->elems[stk->count++];
 	elem->row = row;
 	elem->col = col;
 	elem->value = value;
-	elem->next = stk->top;
-	stk->top = elem;
-	stk->count++;
 }
 
 /*
  * The function removes and returns a pointer to the top elemant
  * of the given stack. If stack is empty, returns NULL.
- * When you finish with the elemant, you have to free it.
+ * The elemant belongs to the stack, and stays valid until the next push.
  */
 StackElem* pop(Stack* stk){
-	StackElem* temp;
-
 	if(is_empty(stk))
 		return NULL;
 
-	temp = stk->top;
-	stk->top = (stk->top)->next;
-	stk->count--;
-	return temp;
+	return &stk->elems[--stk->count];
 }
 
 /*
@@ -79,7 +81,17 @@ StackElem* pop(Stack* stk){
  * If stack is empty, returns NULL
  */
 StackElem* top(Stack* stk){
-	return(stk->top);
+	return elem_at(stk, stk->count - 1);
+}
+
+/*
+ * The function returns a pointer to the elemant at the given depth of the
+ * given stack (0 is the bottom element), or NULL if there is no such elemant.
+ */
+StackElem* elem_at(Stack* stk, int depth){
+	if(depth < 0 || depth >= stk->count)
+		return NULL;
+	return &stk->elems[depth];
 }
 
 /*
@@ -98,13 +110,10 @@ void print_StackElem(StackElem* elem){
 }
 
 void print_Stack(Stack* stk){
-	StackElem* temp = stk->top;
-	int count = 1;
-	while(temp != NULL){
+	int count;
+	for(count = 1; count <= stk->count; count++){
 		printf("%d",count);
-		print_StackElem(temp);
-		temp = temp->next;
-		count++;
+		print_StackElem(top(stk) - (count - 1));
 	}
 	printf("***end of stack***\n");
 }
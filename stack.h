@@ -16,36 +16,38 @@
  * 		row: represents the wanted cell's row.
  * 		col: represents the wanted cell's column
  * 		value: represents the wanted cell's value
- * 		next: represents the next elemant in the stack (below this one)
  *
  */
 typedef struct elem{
 	int row;
 	int col;
 	int value;
-	struct elem* next;
 } StackElem;
 
 
 /*
  * Structure: Stack
  * 		Used to represent a stack of board cells and values.
+ * 		The elements are kept in a single array, from the bottom of the stack up,
+ * 		so pushing and popping don't allocate memory.
  *
  * 		count: The amount of elements currently in the stack.
- * 		top: The first (top) element in the stack.
+ * 		capacity: The amount of elements the array has room for.
+ * 		elems: The elements of the stack (elems[count - 1] is the top element).
  */
 typedef struct stack{
 	int count;
-	StackElem* top;
+	int capacity;
+	StackElem* elems;
 } Stack;
 
 
 /*
- * Function that creates an empty Stack struct.
- * Initializes the amount of elements (count) to 0, and top element to NULL.
+ * Function that creates an empty Stack struct, with room for capacity elements
+ * (for num_solutions, the amount of empty cells). Initializes the amount of elements (count) to 0.
  * Returns a pointer to the stack.
  */
-Stack* initialize_stack();
+Stack* initialize_stack(int capacity);
 
 /*
  * Recieves a stack and safley frees all related memory (including all elemants).
@@ -54,14 +56,16 @@ void destroy_stack(Stack* stk);
 
 
 /*
- * Creates a new elem out of the given data, and puts it at top of the stack.
+ * Puts an elem of the given data at top of the stack.
  * Needs to get the wanted cell's row, column and value.
+ * The stack grows if it is full, so it is best created with the largest size it will reach.
  */
 void push(Stack* stk, int row, int col, int value);
 
 /*
  * The function removes and returns a pointer to the top elemant
  * of the given stack.
+ * The elemant belongs to the stack, and stays valid until the next push.
  */
 StackElem* pop(Stack* stk);
 
@@ -70,6 +74,12 @@ StackElem* pop(Stack* stk);
  */
 StackElem* top(Stack* stk);
 
+/*
+ * The function returns a pointer to the elemant at the given depth of the
+ * given stack (0 is the bottom element), or NULL if there is no such elemant.
+ */
+StackElem* elem_at(Stack* stk, int depth);
+
 /*
  * Function checks if the given stack is empty.
  * Returns 1 if it is empty, 0 otherwise.
@@ -0,0 +1,229 @@
+/*
+ * The "solver_tests" program checks the solvers against fixed puzzles with known amounts of solutions:
+ * every backend's find_solution, is_feasible, bounded count and full count, and the exact count with every
+ * amount of threads and every propagation and symmetry setting, and a count that is stopped,
+ * saved to a checkpoint file and resumed from it.
+ * Run with "make check". Prints every failed check, and exits with 1 if there were any.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "game.h"
+#include "board_utils.h"
+#include "solver.h"
+#include "backend.h"
+#include "parallel.h"
+#include "bignum.h"
+#include "checkpoint.h"
+
+/* the globals of main.c, that the game's modules read their settings from */
+enum game_mode current_mode = EDIT_MODE;
+int mark_errors = 1;
+int num_threads = 1;
+int use_propagation = 1;
+int use_symmetry = 1;
+backend_id solver_backend = BACKTRACK_BACKEND;
+
+
+/*
+ * Structure: Puzzle
+ * 		A fixed board with a known amount of solutions.
+ *
+ * 		name: the name failed checks are reported by.
+ * 		m, n: the block size, in the order of a board file.
+ * 		values: the board's values, a char per cell row by row ('0' for an empty cell).
+ * 		num_solutions: the amount of solutions of the board.
+ */
+typedef struct puzzle_t{
+	const char* name;
+	int m;
+	int n;
+	const char* values;
+	unsigned long num_solutions;
+} Puzzle;
+
+Puzzle puzzles[] = {
+	{"empty 2x2", 2, 2, "0000" "0000" "0000" "0000", 288},
+	{"no solution 2x2", 2, 2, "1200" "0000" "0030" "0040", 0},
+	{"2x3", 2, 3, "100000" "000020" "030000" "000000" "004000" "000000", 15680},
+	{"unique 3x3", 3, 3,
+			"530070000" "600195000" "098000060" "800060003" "400803001"
+			"700020006" "060000280" "000419005" "000080079", 1},
+	{"two solutions 3x3", 3, 3,
+			"000000000" "600195000" "098000060" "800060003" "400803001"
+			"700020006" "060000280" "000419005" "000080079", 2}
+};
+#define NUM_PUZZLES ((int) (sizeof(puzzles) / sizeof(Puzzle)))
+
+int thread_counts[] = {1, 2, 4};
+#define NUM_THREAD_COUNTS ((int) (sizeof(thread_counts) / sizeof(int)))
+
+/* the limit the backends' bounded counts are checked with */
+#define COUNT_LIMIT 50
+/* the puzzle whose count is saved to a checkpoint partway, and the amount of search steps before it is */
+#define CHECKPOINT_PUZZLE 2
+#define CHECKPOINT_STEPS 100
+
+int num_failed = 0;
+
+
+/*
+ * Reports a failed check of the given puzzle if passed is 0.
+ */
+void check(int passed, Puzzle* puzzle, const char* what){
+	if(!passed){
+		printf("FAILED: %s - %s (backend %s, threads %d, propagation %d, symmetry %d)\n",
+				puzzle->name, what, current_backend()->name, num_threads, use_propagation, use_symmetry);
+		num_failed++;
+	}
+}
+
+/*
+ * Creates the board of the given puzzle.
+ */
+Board* create_puzzle_board(Puzzle* puzzle){
+	Board* b = create_blank_board(puzzle->n, puzzle->m);
+	int row, col;
+
+	for(row = 0; row < b->board_size; row++)
+		for(col = 0; col < b->board_size; col++)
+			set_value_simple(b, row, col, puzzle->values[row * b->board_size + col] - '0');
+	return b;
+}
+
+/*
+ * Returns 1 if the two numbers are equal, 0 otherwise.
+ */
+int bignum_equals(BigNum* a, BigNum* b){
+	return a->num_limbs == b->num_limbs && memcmp(a->limbs, b->limbs, a->num_limbs * sizeof(int)) == 0;
+}
+
+/*
+ * Returns 1 if solved is a full board without errors that keeps all the values of b, 0 otherwise.
+ */
+int is_solution_of(Board* solved, Board* b){
+	int row, col;
+
+	if(solved->num_empty_cells_current != 0 || check_board_errors(solved) == 1)
+		return 0;
+	for(row = 0; row < b->board_size; row++)
+		for(col = 0; col < b->board_size; col++)
+			if(get_cell_value(b, row, col) != 0 && get_cell_value(b, row, col) != get_cell_value(solved, row, col))
+				return 0;
+	return 1;
+}
+
+/*
+ * Checks the chosen backend on the given puzzle.
+ * Returns 0 if the backend could not run (ilp without a Gurobi license), 1 otherwise.
+ */
+int check_backend(Puzzle* puzzle){
+	Board* b = create_puzzle_board(puzzle);
+	Board* solved = snapshot_board(b);
+	int expected = puzzle->num_solutions > 0 ? 1 : -1;
+	unsigned long expected_count;
+	BigNum result, expected_all;
+	int ret;
+
+	ret = find_solution(solved, 1);
+	if(ret == 0 && solver_backend == ILP_BACKEND){
+		destroyBoard(solved);
+		destroyBoard(b);
+		return 0;
+	}
+	check(ret == expected, puzzle, "find_solution");
+	if(ret == 1)
+		check(is_solution_of(solved, b), puzzle, "find_solution saved a wrong solution");
+	check(is_feasible(b) == expected, puzzle, "is_feasible");
+
+	expected_count = puzzle->num_solutions < COUNT_LIMIT ? puzzle->num_solutions : COUNT_LIMIT;
+	check(count_solutions_upto(b, COUNT_LIMIT) == (int) expected_count, puzzle, "count_solutions_upto");
+	check(count_solutions_upto(b, 1) == (puzzle->num_solutions > 0 ? 1 : 0), puzzle, "count_solutions_upto 1");
+	bignum_set(&expected_all, puzzle->num_solutions);
+	check(count_all_solutions(b, &result) == 1, puzzle, "count_all_solutions didn't finish");
+	check(bignum_equals(&result, &expected_all), puzzle, "count_all_solutions");
+
+	destroyBoard(solved);
+	destroyBoard(b);
+	return 1;
+}
+
+/*
+ * Checks the exact count of the given puzzle with the current threads, propagation and symmetry.
+ */
+void check_exact_count(Puzzle* puzzle){
+	Board* b = create_puzzle_board(puzzle);
+	BigNum result, expected;
+
+	bignum_set(&expected, puzzle->num_solutions);
+	check(exact_num_solutions(b, num_threads, &result) == 1, puzzle, "exact_num_solutions didn't finish");
+	check(bignum_equals(&result, &expected), puzzle, "exact_num_solutions");
+	check(parallel_count(b, num_threads, 0) == puzzle->num_solutions, puzzle, "parallel_count");
+	destroyBoard(b);
+}
+
+/*
+ * Runs CHECKPOINT_STEPS steps of a count of the given puzzle, saves it to CHECKPOINT_PATH,
+ * and checks that resuming the checkpoint finishes with the puzzle's amount of solutions.
+ */
+void check_checkpoint_round_trip(Puzzle* puzzle){
+	Board* b = create_puzzle_board(puzzle);
+	Search* search = create_search(b, use_symmetry);
+	BigNum result, expected;
+	FILE* file;
+	int steps;
+
+	for(steps = 0; steps < CHECKPOINT_STEPS; steps++)
+		if(search_step(search) == 1)
+			break;
+	check(steps == CHECKPOINT_STEPS && search->stack->count > 0, puzzle, "the count finished before the checkpoint");
+	check(save_checkpoint(CHECKPOINT_PATH, b, search), puzzle, "save_checkpoint");
+	search_unwind(search);
+	destroy_search(search);
+	destroyBoard(b);
+
+	bignum_set(&expected, puzzle->num_solutions);
+	check(resume_count(CHECKPOINT_PATH, &result) == 1, puzzle, "resume_count didn't finish");
+	check(bignum_equals(&result, &expected), puzzle, "resume_count");
+	if((file = fopen(CHECKPOINT_PATH, "r")) != NULL){
+		check(0, puzzle, "the finished checkpoint was not removed");
+		fclose(file);
+		remove(CHECKPOINT_PATH);
+	}
+}
+
+int main(){
+	int i, backend, threads;
+
+	for(backend = 0; backend < NUM_BACKENDS; backend++){
+		solver_backend = (backend_id) backend;
+		for(i = 0; i < NUM_PUZZLES; i++)
+			if(!check_backend(&puzzles[i])){
+				printf("Skipping %s, it could not run.\n", current_backend()->name);
+				break;
+			}
+	}
+	solver_backend = BACKTRACK_BACKEND;
+
+	for(threads = 0; threads < NUM_THREAD_COUNTS; threads++)
+		for(use_propagation = 0; use_propagation <= 1; use_propagation++)
+			for(use_symmetry = 0; use_symmetry <= 1; use_symmetry++){
+				num_threads = thread_counts[threads];
+				for(i = 0; i < NUM_PUZZLES; i++)
+					check_exact_count(&puzzles[i]);
+			}
+
+	num_threads = 1;
+	for(use_propagation = 0; use_propagation <= 1; use_propagation++)
+		for(use_symmetry = 0; use_symmetry <= 1; use_symmetry++)
+			check_checkpoint_round_trip(&puzzles[CHECKPOINT_PUZZLE]);
+
+	if(num_failed > 0){
+		printf("%d checks failed.\n", num_failed);
+		return 1;
+	}
+	printf("All checks passed.\n");
+	return 0;
+}